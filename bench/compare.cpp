@@ -0,0 +1,85 @@
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <lm/compare.h>
+
+using namespace lm::bench;
+
+namespace {
+
+void usage(const char* program) {
+    std::cerr << "usage: " << program << " baseline.csv current.csv [--threshold PERCENT] [--alpha A]" << std::endl;
+}
+
+bool read_file(const std::string& path, std::map<std::string, summary>& results) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "unable to open " << path << std::endl;
+        return false;
+    }
+    results = read_csv(in);
+    return true;
+}
+
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> files;
+    double threshold = 5, alpha = 0.01;
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (std::strcmp(arg, "--threshold") == 0 && has_value) {
+            threshold = std::strtod(argv[++i], nullptr);
+        } else if (std::strcmp(arg, "--alpha") == 0 && has_value) {
+            alpha = std::strtod(argv[++i], nullptr);
+        } else if (arg[0] == '-') {
+            usage(argv[0]);
+            return 2;
+        } else {
+            files.push_back(arg);
+        }
+    }
+    if (files.size() != 2) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    std::map<std::string, summary> baseline, current;
+    if (!read_file(files[0], baseline) || !read_file(files[1], current)) {
+        return 2;
+    }
+
+    const std::vector<comparison> results = compare(baseline, current, threshold / 100, alpha);
+    size_t width = 4, regressions = 0;
+    for (const comparison& c : results) {
+        width = std::max(width, c.name.size());
+    }
+
+    std::cout << std::left << std::setw(static_cast<int>(width)) << "name" << std::right
+              << std::setw(14) << "baseline, ns" << std::setw(14) << "current, ns"
+              << std::setw(10) << "change, %" << std::setw(10) << "p" << '\n';
+    for (const comparison& c : results) {
+        std::cout << std::left << std::setw(static_cast<int>(width)) << c.name << std::right << std::fixed
+                  << std::setw(14) << std::setprecision(1) << c.baseline
+                  << std::setw(14) << std::setprecision(1) << c.current
+                  << std::setw(10) << std::setprecision(2) << c.change * 100
+                  << std::setw(10) << std::setprecision(4) << c.p_value
+                  << (c.regression ? "  REGRESSION" : "") << '\n';
+        if (c.regression) {
+            regressions++;
+        }
+    }
+
+    if (regressions > 0) {
+        std::cout << regressions << " regression(s) above " << threshold << "% at alpha " << alpha << std::endl;
+        return 1;
+    }
+    return 0;
+}
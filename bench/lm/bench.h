@@ -0,0 +1,434 @@
+/**
+ * @file
+ * @brief Minimal benchmark framework used by `lm_bench`
+ *
+ * Each benchmark runs a function in a loop. Iteration count of a sample is calibrated so sample lasts at least
+ * `options::min_sample_time` seconds, then warm-up samples are discarded and `options::repetitions` samples are measured.
+ * Throughput is computed from median time per iteration.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// defined by build system
+#ifndef LM_BENCH_FLAGS
+#define LM_BENCH_FLAGS ""
+#endif
+
+#ifndef LM_BENCH_GIT_HASH
+#define LM_BENCH_GIT_HASH ""
+#endif
+
+namespace lm {
+namespace bench {
+
+/**
+ * @brief prevents compiler from optimizing out computation of `value` or assuming that `value` is unchanged
+ */
+template <typename T>
+inline void do_not_optimize(T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+struct benchmark {
+
+    /**
+     * @brief group of benchmarks, e.g. `matrix` or `vec`
+     */
+    std::string group;
+
+    /**
+     * @brief name in form `operation/type/size`
+     */
+    std::string name;
+
+    /**
+     * @brief floating point operations per iteration
+     */
+    double flops;
+
+    /**
+     * @brief bytes of memory read and written per iteration
+     */
+    double bytes;
+
+    /**
+     * @brief runs given count of iterations
+     */
+    std::function<void(size_t)> run;
+
+    /**
+     * @brief name of benchmark in same group which does same work without abstractions, empty if none
+     */
+    std::string baseline;
+
+    std::string full_name() const {
+        return group + "/" + name;
+    }
+
+};
+
+inline std::vector<benchmark>& registry() {
+    static std::vector<benchmark> benchmarks;
+    return benchmarks;
+}
+
+/**
+ * @brief registers benchmark which calls `f()` once per iteration
+ */
+template <typename F>
+void add(const std::string& group, const std::string& name, double flops, double bytes, F f) {
+    registry().push_back(benchmark{group, name, flops, bytes, [f](size_t iterations) mutable {
+        for (size_t i = 0; i < iterations; i++) {
+            f();
+        }
+    }, std::string()});
+}
+
+/**
+ * @brief registers benchmark which calls `f()` once per iteration and is compared with `baseline` benchmark
+ */
+template <typename F>
+void add(const std::string& group, const std::string& name, const std::string& baseline, double flops, double bytes, F f) {
+    add(group, name, flops, bytes, f);
+    registry().back().baseline = baseline;
+}
+
+/**
+ * @brief calls registration function during static initialization
+ */
+struct registrar {
+    explicit registrar(void (*f)()) {
+        f();
+    }
+};
+
+struct statistics {
+
+    double min;
+    double max;
+    double mean;
+    double median;
+    double stddev;
+
+    /**
+     * @brief coefficient of variation, i.e. relative standard deviation
+     */
+    double cv() const {
+        return mean > 0 ? stddev / mean : 0;
+    }
+
+    static statistics of(std::vector<double> samples) {
+        statistics s = {};
+        if (samples.empty()) {
+            return s;
+        }
+        std::sort(samples.begin(), samples.end());
+        const size_t n = samples.size();
+        s.min = samples.front();
+        s.max = samples.back();
+        s.median = n % 2 == 1 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+
+        double sum = 0;
+        for (double v : samples) {
+            sum += v;
+        }
+        s.mean = sum / static_cast<double>(n);
+
+        double sq = 0;
+        for (double v : samples) {
+            sq += (v - s.mean) * (v - s.mean);
+        }
+        s.stddev = n > 1 ? std::sqrt(sq / static_cast<double>(n - 1)) : 0;
+        return s;
+    }
+
+};
+
+struct result {
+
+    const benchmark* bench;
+
+    /**
+     * @brief iterations per sample
+     */
+    size_t iterations;
+
+    /**
+     * @brief time per iteration in nanoseconds for each sample
+     */
+    std::vector<double> samples;
+
+    /**
+     * @brief statistics of `samples`
+     */
+    statistics time;
+
+    double gflops() const {
+        return time.median > 0 ? bench->flops / time.median : 0;
+    }
+
+    double gbps() const {
+        return time.median > 0 ? bench->bytes / time.median : 0;
+    }
+
+};
+
+struct options {
+    std::string filter;
+    size_t warmup = 1;
+    size_t repetitions = 10;
+    double min_sample_time = 0.01;
+};
+
+inline bool matches(const benchmark& b, const std::string& filter) {
+    return filter.empty() || b.full_name().find(filter) != std::string::npos;
+}
+
+/**
+ * @brief runs `iterations` iterations of benchmark `b`
+ * @return elapsed time in seconds
+ */
+inline double time_sample(const benchmark& b, size_t iterations) {
+    const auto start = std::chrono::steady_clock::now();
+    b.run(iterations);
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+inline result run(const benchmark& b, const options& o) {
+    result r;
+    r.bench = &b;
+
+    // calibration also warms up caches and branch predictors
+    size_t iterations = 1;
+    for (;;) {
+        const double t = time_sample(b, iterations);
+        if (t >= o.min_sample_time || iterations >= (size_t(1) << 30)) {
+            break;
+        }
+        const double scale = t > 0 ? o.min_sample_time / t * 1.2 : 10;
+        iterations = static_cast<size_t>(static_cast<double>(iterations) * std::min(10., std::max(2., scale)));
+    }
+    r.iterations = iterations;
+
+    for (size_t i = 0; i < o.warmup; i++) {
+        time_sample(b, iterations);
+    }
+    for (size_t i = 0; i < o.repetitions; i++) {
+        r.samples.push_back(time_sample(b, iterations) * 1e9 / static_cast<double>(iterations));
+    }
+    r.time = statistics::of(r.samples);
+    return r;
+}
+
+/**
+ * @brief writes results as a human readable table
+ */
+inline void report(std::ostream& out, const std::vector<result>& results) {
+    size_t width = 4;
+    for (const result& r : results) {
+        width = std::max(width, r.bench->full_name().size());
+    }
+
+    out << std::left << std::setw(static_cast<int>(width)) << "name" << std::right
+        << std::setw(14) << "median, ns" << std::setw(10) << "cv, %"
+        << std::setw(12) << "GFLOP/s" << std::setw(12) << "GB/s" << '\n';
+    for (const result& r : results) {
+        out << std::left << std::setw(static_cast<int>(width)) << r.bench->full_name() << std::right << std::fixed
+            << std::setw(14) << std::setprecision(1) << r.time.median
+            << std::setw(10) << std::setprecision(2) << r.time.cv() * 100
+            << std::setw(12) << std::setprecision(3) << r.gflops()
+            << std::setw(12) << std::setprecision(3) << r.gbps() << '\n';
+    }
+}
+
+/**
+ * @brief time ratio of benchmark and its baseline
+ */
+struct penalty {
+    const result* measured;
+    const result* baseline;
+
+    double ratio() const {
+        return baseline->time.median > 0 ? measured->time.median / baseline->time.median : 0;
+    }
+};
+
+/**
+ * @brief finds penalties of results whose baselines were also run
+ */
+inline std::vector<penalty> penalties(const std::vector<result>& results) {
+    std::vector<penalty> p;
+    for (const result& r : results) {
+        if (r.bench->baseline.empty()) {
+            continue;
+        }
+        for (const result& b : results) {
+            if (b.bench->group == r.bench->group && b.bench->name == r.bench->baseline) {
+                p.push_back(penalty{&r, &b});
+                break;
+            }
+        }
+    }
+    return p;
+}
+
+/**
+ * @brief writes penalties as a human readable table, ratios above `max_ratio` are marked
+ */
+inline void report(std::ostream& out, const std::vector<penalty>& penalties, double max_ratio) {
+    size_t width = 4;
+    for (const penalty& p : penalties) {
+        width = std::max(width, p.measured->bench->full_name().size());
+    }
+
+    out << std::left << std::setw(static_cast<int>(width)) << "name" << std::right
+        << std::setw(14) << "median, ns" << std::setw(14) << "baseline, ns" << std::setw(10) << "ratio" << '\n';
+    for (const penalty& p : penalties) {
+        out << std::left << std::setw(static_cast<int>(width)) << p.measured->bench->full_name() << std::right << std::fixed
+            << std::setw(14) << std::setprecision(1) << p.measured->time.median
+            << std::setw(14) << std::setprecision(1) << p.baseline->time.median
+            << std::setw(10) << std::setprecision(2) << p.ratio()
+            << (max_ratio > 0 && p.ratio() > max_ratio ? "  EXCEEDS" : "") << '\n';
+    }
+}
+
+/**
+ * @brief description of machine and build which produced results
+ */
+struct environment {
+
+    std::string cpu;
+    std::string compiler;
+    std::string flags;
+    std::string git_hash;
+
+    static environment current() {
+        environment e;
+        e.cpu = cpu_model();
+        e.compiler = compiler_name();
+        e.flags = LM_BENCH_FLAGS;
+        e.git_hash = LM_BENCH_GIT_HASH;
+        return e;
+    }
+
+    static std::string cpu_model() {
+        std::ifstream in("/proc/cpuinfo");
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.compare(0, 10, "model name") == 0) {
+                const size_t p = line.find_first_not_of(" \t", line.find(':') + 1);
+                if (p != std::string::npos) {
+                    return line.substr(p);
+                }
+            }
+        }
+        return "unknown";
+    }
+
+    static std::string compiler_name() {
+#if defined(__clang__)
+        return "clang " __clang_version__;
+#elif defined(__GNUC__)
+        return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+        return "msvc " + std::to_string(_MSC_VER);
+#else
+        return "unknown";
+#endif
+    }
+
+};
+
+inline std::string json_string(const std::string& s) {
+    std::ostringstream out;
+    out << '"';
+    for (char c : s) {
+        switch (c) {
+        case '"': out << "\\\""; break;
+        case '\\': out << "\\\\"; break;
+        case '\n': out << "\\n"; break;
+        case '\t': out << "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+            } else {
+                out << c;
+            }
+        }
+    }
+    out << '"';
+    return out.str();
+}
+
+/**
+ * @brief writes environment and results as JSON document
+ */
+inline void write_json(std::ostream& out, const environment& env, const std::vector<result>& results) {
+    out << std::setprecision(17);
+    out << "{\n  \"context\": {\n"
+        << "    \"cpu\": " << json_string(env.cpu) << ",\n"
+        << "    \"compiler\": " << json_string(env.compiler) << ",\n"
+        << "    \"flags\": " << json_string(env.flags) << ",\n"
+        << "    \"git_hash\": " << json_string(env.git_hash) << "\n"
+        << "  },\n  \"benchmarks\": [";
+    for (size_t i = 0; i < results.size(); i++) {
+        const result& r = results[i];
+        out << (i == 0 ? "\n" : ",\n")
+            << "    {\"group\": " << json_string(r.bench->group)
+            << ", \"name\": " << json_string(r.bench->name)
+            << ", \"flops\": " << r.bench->flops
+            << ", \"bytes\": " << r.bench->bytes
+            << ", \"iterations\": " << r.iterations
+            << ", \"min_ns\": " << r.time.min
+            << ", \"median_ns\": " << r.time.median
+            << ", \"mean_ns\": " << r.time.mean
+            << ", \"stddev_ns\": " << r.time.stddev
+            << ", \"gflops\": " << r.gflops()
+            << ", \"gbps\": " << r.gbps()
+            << ", \"samples_ns\": [";
+        for (size_t j = 0; j < r.samples.size(); j++) {
+            out << (j == 0 ? "" : ", ") << r.samples[j];
+        }
+        out << "]}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+/**
+ * @brief writes environment (as `#` comment lines) and results as CSV
+ */
+inline void write_csv(std::ostream& out, const environment& env, const std::vector<result>& results) {
+    out << std::setprecision(17);
+    out << "# cpu: " << env.cpu << '\n'
+        << "# compiler: " << env.compiler << '\n'
+        << "# flags: " << env.flags << '\n'
+        << "# git_hash: " << env.git_hash << '\n';
+    out << "group,name,flops,bytes,iterations,samples,min_ns,median_ns,mean_ns,stddev_ns,gflops,gbps\n";
+    for (const result& r : results) {
+        out << r.bench->group << ',' << r.bench->name << ','
+            << r.bench->flops << ',' << r.bench->bytes << ','
+            << r.iterations << ',' << r.samples.size() << ','
+            << r.time.min << ',' << r.time.median << ',' << r.time.mean << ',' << r.time.stddev << ','
+            << r.gflops() << ',' << r.gbps() << '\n';
+    }
+}
+
+}
+}
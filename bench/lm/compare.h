@@ -0,0 +1,179 @@
+/**
+ * @file
+ * @brief Comparison of benchmark results written by `lm_bench --csv`
+ *
+ * Benchmark is considered regressed when its mean time grew more than by threshold
+ * and Welch's t-test shows that growth is statistically significant.
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstdlib>
+#include <istream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace lm {
+namespace bench {
+
+/**
+ * @brief summary of benchmark read from result file
+ */
+struct summary {
+    std::string name;
+    size_t samples;
+    double median;
+    double mean;
+    double stddev;
+};
+
+/**
+ * @brief reads results written by `write_csv`, key of map is full benchmark name
+ */
+inline std::map<std::string, summary> read_csv(std::istream& in) {
+    std::map<std::string, summary> results;
+    std::string line;
+    bool header = true;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        if (header) {
+            header = false;
+            continue;
+        }
+
+        std::vector<std::string> fields;
+        std::istringstream ls(line);
+        std::string field;
+        while (std::getline(ls, field, ',')) {
+            fields.push_back(field);
+        }
+        if (fields.size() < 12) {
+            throw std::runtime_error("malformed result line: " + line);
+        }
+
+        summary s;
+        s.name = fields[0] + "/" + fields[1];
+        s.samples = std::strtoul(fields[5].c_str(), nullptr, 10);
+        s.median = std::strtod(fields[7].c_str(), nullptr);
+        s.mean = std::strtod(fields[8].c_str(), nullptr);
+        s.stddev = std::strtod(fields[9].c_str(), nullptr);
+        results[s.name] = s;
+    }
+    return results;
+}
+
+/**
+ * @brief continued fraction for regularized incomplete beta function
+ */
+inline double incomplete_beta_fraction(double a, double b, double x) {
+    const double tiny = 1e-300;
+    double c = 1, d = 1 - (a + b) * x / (a + 1);
+    d = 1 / (std::abs(d) < tiny ? tiny : d);
+    double h = d;
+    for (int m = 1; m <= 300; m++) {
+        const double m2 = 2 * m;
+        double aa = m * (b - m) * x / ((a + m2 - 1) * (a + m2));
+        d = 1 + aa * d;
+        d = 1 / (std::abs(d) < tiny ? tiny : d);
+        c = 1 + aa / c;
+        c = std::abs(c) < tiny ? tiny : c;
+        h *= d * c;
+
+        aa = -(a + m) * (a + b + m) * x / ((a + m2) * (a + m2 + 1));
+        d = 1 + aa * d;
+        d = 1 / (std::abs(d) < tiny ? tiny : d);
+        c = 1 + aa / c;
+        c = std::abs(c) < tiny ? tiny : c;
+        const double delta = d * c;
+        h *= delta;
+        if (std::abs(delta - 1) < 1e-12) {
+            break;
+        }
+    }
+    return h;
+}
+
+/**
+ * @brief regularized incomplete beta function @f$ I_x(a, b) @f$
+ */
+inline double incomplete_beta(double a, double b, double x) {
+    if (x <= 0) {
+        return 0;
+    }
+    if (x >= 1) {
+        return 1;
+    }
+    const double front = std::exp(std::lgamma(a + b) - std::lgamma(a) - std::lgamma(b) +
+        a * std::log(x) + b * std::log(1 - x));
+    return x < (a + 1) / (a + b + 2)
+        ? front * incomplete_beta_fraction(a, b, x) / a
+        : 1 - front * incomplete_beta_fraction(b, a, 1 - x) / b;
+}
+
+/**
+ * @brief one-sided p-value of Welch's t-test for hypothesis that mean of `current` is greater than mean of `baseline`
+ */
+inline double welch_p_value(const summary& baseline, const summary& current) {
+    if (baseline.samples < 2 || current.samples < 2) {
+        return 1;
+    }
+    const double v1 = baseline.stddev * baseline.stddev / static_cast<double>(baseline.samples);
+    const double v2 = current.stddev * current.stddev / static_cast<double>(current.samples);
+    const double diff = current.mean - baseline.mean;
+    if (v1 + v2 == 0) {
+        return diff > 0 ? 0 : 1;
+    }
+
+    const double t = diff / std::sqrt(v1 + v2);
+    const double df = (v1 + v2) * (v1 + v2) /
+        (v1 * v1 / static_cast<double>(baseline.samples - 1) + v2 * v2 / static_cast<double>(current.samples - 1));
+
+    // P(T > t) of Student's t-distribution with df degrees of freedom
+    const double tail = 0.5 * incomplete_beta(df / 2, 0.5, df / (df + t * t));
+    return t > 0 ? tail : 1 - tail;
+}
+
+struct comparison {
+    std::string name;
+    double baseline;
+    double current;
+    double change;
+    double p_value;
+    bool regression;
+};
+
+/**
+ * @brief compares benchmarks present in both result sets
+ * @param threshold minimal relative growth of mean time to report regression, e.g. `0.05`
+ * @param alpha significance level
+ */
+inline std::vector<comparison> compare(const std::map<std::string, summary>& baseline,
+                                       const std::map<std::string, summary>& current,
+                                       double threshold, double alpha) {
+    std::vector<comparison> result;
+    for (const auto& c : current) {
+        const auto b = baseline.find(c.first);
+        if (b == baseline.end() || b->second.mean <= 0) {
+            continue;
+        }
+        comparison r;
+        r.name = c.first;
+        r.baseline = b->second.mean;
+        r.current = c.second.mean;
+        r.change = (r.current - r.baseline) / r.baseline;
+        r.p_value = welch_p_value(b->second, c.second);
+        r.regression = r.change > threshold && r.p_value < alpha;
+        result.push_back(r);
+    }
+    return result;
+}
+
+}
+}
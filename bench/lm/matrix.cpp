@@ -0,0 +1,203 @@
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include <lm/bench.h>
+#include <lm/matrix/matrix.h>
+#include <lm/matrix/recursive.h>
+#include <lm/matrix/row_pointer.h>
+#include <lm/vec/vec.h>
+
+using namespace lm;
+using namespace lm::bench;
+
+namespace {
+
+// dense matrix of pseudo-random values in [-1, 1), so LU-factorization swaps rows on almost every step
+// like on real data, while with partial pivoting its results stay bounded for any size
+template <typename M>
+M make_matrix(size_t n, size_t seed) {
+    M m;
+    m.resize(n, n);
+    uint64_t x = seed * 0x9e3779b97f4a7c15ull + 1;
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            x = x * 6364136223846793005ull + 1442695040888963407ull;
+            m(i, j) = static_cast<typename M::value_type>(static_cast<double>(x >> 11) / 4503599627370496. - 1.);
+        }
+    }
+    return m;
+}
+
+template <typename M>
+void add_matrix_benchmarks(const std::string& type, size_t n) {
+    typedef typename M::value_type value_type;
+    typedef typename M::value_matrix_type value_matrix_type;
+
+    const std::string suffix = "/" + type + "/" + std::to_string(n);
+    const double size = static_cast<double>(n);
+    const double n2 = size * size, n3 = n2 * size;
+    const double s = sizeof(value_type);
+
+    M a = make_matrix<M>(n, 1);
+    M b = make_matrix<M>(n, 2);
+
+    typedef typename matrix_product<M, M>::value_matrix_type product_type;
+    product_type p = product<M, M, product_type>(a, b);
+    add("matrix", "product" + suffix, 2 * n3, 3 * n2 * s, [a, b, p]() mutable {
+        do_not_optimize(a);
+        product(a, b, p);
+        do_not_optimize(p);
+    });
+
+    add("matrix", "product_par" + suffix, 2 * n3, 3 * n2 * s, [a, b, p]() mutable {
+        do_not_optimize(a);
+        product(execution::par, a, b, p);
+        do_not_optimize(p);
+    });
+
+    add("matrix", "product_recursive_par" + suffix, 2 * n3, 3 * n2 * s, [a, b, p]() mutable {
+        do_not_optimize(a);
+        product_recursive(execution::par, a, b, p);
+        do_not_optimize(p);
+    });
+
+    // product with transposed first operand, as in normal equations, without transposing it
+    add("matrix", "product_tn" + suffix, 2 * n3, 3 * n2 * s, [a, b, p]() mutable {
+        do_not_optimize(a);
+        product(transposed(a), b, p);
+        do_not_optimize(p);
+    });
+
+    add("matrix", "product_homogeneous" + suffix, 2 * n3, 3 * n2 * s, [a, b, p]() mutable {
+        do_not_optimize(a);
+        product_homogeneous(a, b, p);
+        do_not_optimize(p);
+    });
+
+    typename matrix_transpose<M>::value_matrix_type t = transpose(a);
+    add("matrix", "transpose" + suffix, 0, 2 * n2 * s, [a, t]() mutable {
+        do_not_optimize(a);
+        transpose(a, t);
+        do_not_optimize(t);
+    });
+
+    add("matrix", "transpose_recursive" + suffix, 0, 2 * n2 * s, [a, t]() mutable {
+        do_not_optimize(a);
+        transpose_recursive(execution::seq, a, t);
+        do_not_optimize(t);
+    });
+
+    // includes copying of matrix which is factorized
+    permutation_matrix<value_matrix_type> lu(a);
+    add("matrix", "lu_decomposition" + suffix, 2 * n3 / 3, 2 * n2 * s, [a, lu]() mutable {
+        do_not_optimize(a);
+        lu.assign(a);
+        lu_decomposition(lu);
+        do_not_optimize(lu);
+    });
+
+    // same with rows swapped in memory instead of permutation indirection
+    pivoted_matrix<value_matrix_type> pivoted(a);
+    add("matrix", "lu_decomposition_pivoted" + suffix, 2 * n3 / 3, 2 * n2 * s, [a, pivoted]() mutable {
+        do_not_optimize(a);
+        pivoted.assign(a);
+        lu_decomposition(pivoted);
+        do_not_optimize(pivoted);
+    });
+
+    add("matrix", "lu_decomposition_par" + suffix, 2 * n3 / 3, 2 * n2 * s, [a, pivoted]() mutable {
+        do_not_optimize(a);
+        pivoted.assign(a);
+        lu_decomposition(execution::par, pivoted);
+        do_not_optimize(pivoted);
+    });
+
+    add("matrix", "lu_decomposition_recursive_par" + suffix, 2 * n3 / 3, 2 * n2 * s, [a, pivoted]() mutable {
+        do_not_optimize(a);
+        pivoted.assign(a);
+        lu_decomposition_recursive(execution::par, pivoted);
+        do_not_optimize(pivoted);
+    });
+
+    // solves for n right-hand sides with factorization computed once, includes copying of right-hand side
+    permutation_matrix<value_matrix_type> factorized(a);
+    lu_decomposition(factorized);
+    value_matrix_type x(b);
+    add("matrix", "lu_substitute" + suffix, 2 * n3, 3 * n2 * s, [b, factorized, x]() mutable {
+        do_not_optimize(b);
+        lu_solve(factorized, b, x);
+        do_not_optimize(x);
+    });
+
+    value_matrix_type inv(a);
+    add("matrix", "invert_matrix" + suffix, 2 * n3, 2 * n2 * s, [a, inv]() mutable {
+        do_not_optimize(a);
+        invert_matrix(a, inv);
+        do_not_optimize(inv);
+    });
+
+    // includes copying of matrix which is inverted
+    add("matrix", "invert_inplace" + suffix, 2 * n3, 2 * n2 * s, [a, inv]() mutable {
+        do_not_optimize(a);
+        inv.assign(a);
+        invert_inplace(inv);
+        do_not_optimize(inv);
+    });
+
+    add("matrix", "determinant" + suffix, 2 * n3 / 3, n2 * s, [a]() mutable {
+        do_not_optimize(a);
+        value_type d = determinant(a);
+        do_not_optimize(d);
+    });
+
+    value_matrix_type c(a);
+    add("matrix", "assign" + suffix, 0, 2 * n2 * s, [a, c]() mutable {
+        do_not_optimize(a);
+        c.assign(a);
+        do_not_optimize(c);
+    });
+}
+
+// reverses order of rows, i.e. rows/2 row swaps
+template <typename M>
+void add_row_benchmarks(const std::string& type, size_t n) {
+    const std::string suffix = "/" + type + "/" + std::to_string(n);
+    const double s = sizeof(typename M::value_type);
+
+    M m = make_matrix<M>(n, 1);
+    add("matrix", "reverse_rows" + suffix, 0, static_cast<double>(n * n) * s, [m]() mutable {
+        do_not_optimize(m);
+        for (size_t i = 0; i < m.rows() / 2; i++) {
+            m.swap_row(i, m.rows() - 1 - i);
+        }
+        do_not_optimize(m);
+    });
+}
+
+template <size_t... N>
+void add_static_benchmarks(std::index_sequence<N...>) {
+    const int dummy[] = { 0, (
+        add_matrix_benchmarks<array_matrix<double, N, N>>("array_matrix", N),
+        add_matrix_benchmarks<flat_array_matrix<double, N, N>>("flat_array_matrix", N),
+        add_matrix_benchmarks<container_matrix<vec, double, N, N>>("container_matrix", N),
+        0)... };
+    (void) dummy;
+}
+
+void register_benchmarks() {
+    add_static_benchmarks(std::index_sequence<2, 3, 4, 8, 16>());
+
+    for (size_t n : {2, 3, 4, 8, 16, 64, 256}) {
+        add_matrix_benchmarks<vector_matrix<double>>("vector_matrix", n);
+        add_matrix_benchmarks<transpose_matrix<vector_matrix<double>>>("transpose_matrix", n);
+        add_matrix_benchmarks<permutation_matrix<vector_matrix<double>>>("permutation_matrix", n);
+        add_row_benchmarks<vector_matrix<double>>("vector_matrix", n);
+        add_row_benchmarks<vector_row_pointer_matrix<double>>("row_pointer_matrix", n);
+    }
+}
+
+registrar r(&register_benchmarks);
+
+}
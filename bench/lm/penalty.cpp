@@ -0,0 +1,110 @@
+#include <array>
+#include <cstddef>
+#include <numeric>
+#include <string>
+#include <utility>
+
+#include <lm/bench.h>
+#include <lm/vec/vec.h>
+
+using namespace lm;
+using namespace lm::bench;
+
+// Abstraction penalty: each `lm` benchmark is paired with `raw` benchmark which does same work by plain loops over arrays.
+// Sizes 2..4 use `vec_storage` with named members, larger sizes use `std::array` storage.
+
+namespace {
+
+template <typename T, size_t N>
+void add_penalty_benchmarks(const std::string& type) {
+    const std::string suffix = "/" + type + "/" + std::to_string(N);
+    const double n = N, s = sizeof(T);
+
+    vec<T, N> a, b;
+    std::array<T, N> ra, rb;
+    for (size_t i = 0; i < N; i++) {
+        ra[i] = a[i] = static_cast<T>((i * 3 + 1) % 7 + 1);
+        rb[i] = b[i] = static_cast<T>((i * 3 + 2) % 7 + 1);
+    }
+
+    // generic_vec::scalar_product, iterates both vectors by random_access_iterator
+    add("penalty", "scalar_product/lm" + suffix, "scalar_product/raw" + suffix, 2 * n, 2 * n * s, [a, b]() mutable {
+        do_not_optimize(a);
+        T r = a.scalar_product(b);
+        do_not_optimize(r);
+    });
+    add("penalty", "scalar_product/raw" + suffix, 2 * n, 2 * n * s, [ra, rb]() mutable {
+        do_not_optimize(ra);
+        const T* pa = ra.data();
+        const T* pb = rb.data();
+        T r = T();
+        for (size_t i = 0; i < N; i++) {
+            r += pa[i] * pb[i];
+        }
+        do_not_optimize(r);
+    });
+
+    // iteration of vector by its begin()/end()
+    add("penalty", "iterate/lm" + suffix, "iterate/raw" + suffix, n, n * s, [a]() mutable {
+        do_not_optimize(a);
+        T r = std::accumulate(a.begin(), a.end(), T());
+        do_not_optimize(r);
+    });
+    add("penalty", "iterate/raw" + suffix, n, n * s, [ra]() mutable {
+        do_not_optimize(ra);
+        const T* p = ra.data();
+        T r = T();
+        for (size_t i = 0; i < N; i++) {
+            r += p[i];
+        }
+        do_not_optimize(r);
+    });
+
+    // elementwise operation with other vector, uses range() of class
+    add("penalty", "add_assign/lm" + suffix, "add_assign/raw" + suffix, n, 3 * n * s, [a, b]() mutable {
+        do_not_optimize(b);
+        a += b;
+        do_not_optimize(a);
+    });
+    add("penalty", "add_assign/raw" + suffix, n, 3 * n * s, [ra, rb]() mutable {
+        do_not_optimize(rb);
+        T* pa = ra.data();
+        const T* pb = rb.data();
+        for (size_t i = 0; i < N; i++) {
+            pa[i] += pb[i];
+        }
+        do_not_optimize(ra);
+    });
+
+    // scalar broadcast, uses value_range
+    add("penalty", "broadcast/lm" + suffix, "broadcast/raw" + suffix, n, 2 * n * s, [a]() mutable {
+        int v = 3;
+        do_not_optimize(v);
+        a += v;
+        do_not_optimize(a);
+    });
+    add("penalty", "broadcast/raw" + suffix, n, 2 * n * s, [ra]() mutable {
+        int v = 3;
+        do_not_optimize(v);
+        T* p = ra.data();
+        for (size_t i = 0; i < N; i++) {
+            p[i] += v;
+        }
+        do_not_optimize(ra);
+    });
+}
+
+template <typename T, size_t... N>
+void add_sizes(const std::string& type, std::index_sequence<N...>) {
+    const int dummy[] = { 0, (add_penalty_benchmarks<T, N>(type), 0)... };
+    (void) dummy;
+}
+
+void register_benchmarks() {
+    add_sizes<float>("float", std::index_sequence<2, 3, 4, 16, 64>());
+    add_sizes<double>("double", std::index_sequence<2, 3, 4, 16, 64>());
+}
+
+registrar r(&register_benchmarks);
+
+}
@@ -0,0 +1,88 @@
+#include <cstddef>
+#include <string>
+#include <utility>
+
+#include <lm/bench.h>
+#include <lm/vec/vec.h>
+
+using namespace lm;
+using namespace lm::bench;
+
+namespace {
+
+template <typename T, size_t N>
+vec<T, N> make_vec(size_t seed) {
+    vec<T, N> v;
+    for (size_t i = 0; i < N; i++) {
+        v[i] = static_cast<T>((i * 3 + seed) % 7 + 1);
+    }
+    return v;
+}
+
+template <typename T, size_t N>
+void add_vec_benchmarks(const std::string& type) {
+    const std::string suffix = "/" + type + "/" + std::to_string(N);
+    const double n = N, s = sizeof(T);
+
+    vec<T, N> a = make_vec<T, N>(1);
+    vec<T, N> b = make_vec<T, N>(2);
+
+    add("vec", "scalar_product" + suffix, 2 * n, 2 * n * s, [a, b]() mutable {
+        do_not_optimize(a);
+        T r = a.scalar_product(b);
+        do_not_optimize(r);
+    });
+
+    // fixed order of summation, see lm/util/reduce.h
+    add("vec", "scalar_product_reproducible" + suffix, 2 * n, 2 * n * s, [a, b]() mutable {
+        do_not_optimize(a);
+        T r = a.scalar_product(execution::seq, b);
+        do_not_optimize(r);
+    });
+
+    add("vec", "length" + suffix, 2 * n + 1, n * s, [a]() mutable {
+        do_not_optimize(a);
+        T r = a.length();
+        do_not_optimize(r);
+    });
+
+    vec<T, N> c = a;
+    add("vec", "add_assign" + suffix, n, 3 * n * s, [b, c]() mutable {
+        do_not_optimize(b);
+        c += b;
+        do_not_optimize(c);
+    });
+
+    add("vec", "add" + suffix, n, 3 * n * s, [a, b]() mutable {
+        do_not_optimize(a);
+        vec<T, N> r = a + b;
+        do_not_optimize(r);
+    });
+
+    add("vec", "multiply" + suffix, n, 3 * n * s, [a, b]() mutable {
+        do_not_optimize(a);
+        vec<T, N> r = a * b;
+        do_not_optimize(r);
+    });
+
+    add("vec", "negate" + suffix, n, 2 * n * s, [a]() mutable {
+        do_not_optimize(a);
+        vec<T, N> r = -a;
+        do_not_optimize(r);
+    });
+}
+
+template <typename T, size_t... N>
+void add_sizes(const std::string& type, std::index_sequence<N...>) {
+    const int dummy[] = { 0, (add_vec_benchmarks<T, N>(type), 0)... };
+    (void) dummy;
+}
+
+void register_benchmarks() {
+    add_sizes<float>("float", std::index_sequence<2, 3, 4, 8, 16, 64, 4096>());
+    add_sizes<double>("double", std::index_sequence<2, 3, 4, 8, 16, 64, 4096>());
+}
+
+registrar r(&register_benchmarks);
+
+}
@@ -0,0 +1,105 @@
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <lm/bench.h>
+
+using namespace lm::bench;
+
+namespace {
+
+void usage(const char* program) {
+    std::cerr << "usage: " << program << " [filter] [--list] [--reps N] [--warmup N] [--min-time SECONDS]"
+              << " [--json FILE] [--csv FILE] [--max-penalty RATIO]" << std::endl;
+}
+
+template <typename Writer>
+bool write_file(const std::string& path, Writer writer) {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "unable to open " << path << std::endl;
+        return false;
+    }
+    writer(out);
+    return true;
+}
+
+}
+
+int main(int argc, char** argv) {
+    options o;
+    bool list = false;
+    std::string json, csv;
+    double max_penalty = 0;
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (std::strcmp(arg, "--list") == 0) {
+            list = true;
+        } else if (std::strcmp(arg, "--reps") == 0 && has_value) {
+            o.repetitions = std::strtoul(argv[++i], nullptr, 10);
+        } else if (std::strcmp(arg, "--warmup") == 0 && has_value) {
+            o.warmup = std::strtoul(argv[++i], nullptr, 10);
+        } else if (std::strcmp(arg, "--min-time") == 0 && has_value) {
+            o.min_sample_time = std::strtod(argv[++i], nullptr);
+        } else if (std::strcmp(arg, "--json") == 0 && has_value) {
+            json = argv[++i];
+        } else if (std::strcmp(arg, "--csv") == 0 && has_value) {
+            csv = argv[++i];
+        } else if (std::strcmp(arg, "--max-penalty") == 0 && has_value) {
+            max_penalty = std::strtod(argv[++i], nullptr);
+        } else if (arg[0] == '-') {
+            usage(argv[0]);
+            return 1;
+        } else {
+            o.filter = arg;
+        }
+    }
+
+    std::vector<result> results;
+    for (const benchmark& b : registry()) {
+        if (!matches(b, o.filter)) {
+            continue;
+        }
+        if (list) {
+            std::cout << b.full_name() << '\n';
+            continue;
+        }
+        results.push_back(run(b, o));
+        std::cerr << '.' << std::flush;
+    }
+    if (list) {
+        return 0;
+    }
+
+    std::cerr << std::endl;
+    report(std::cout, results);
+
+    size_t exceeded = 0;
+    const std::vector<penalty> p = penalties(results);
+    if (!p.empty()) {
+        std::cout << '\n';
+        report(std::cout, p, max_penalty);
+        for (const penalty& i : p) {
+            if (max_penalty > 0 && i.ratio() > max_penalty) {
+                exceeded++;
+            }
+        }
+    }
+
+    const environment env = environment::current();
+    if (!json.empty() && !write_file(json, [&](std::ostream& out) { write_json(out, env, results); })) {
+        return 1;
+    }
+    if (!csv.empty() && !write_file(csv, [&](std::ostream& out) { write_csv(out, env, results); })) {
+        return 1;
+    }
+    if (exceeded > 0) {
+        std::cout << exceeded << " benchmark(s) exceed abstraction penalty " << max_penalty << std::endl;
+        return 1;
+    }
+    return 0;
+}
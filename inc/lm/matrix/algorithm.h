@@ -7,11 +7,21 @@
 
 #include <cstddef>
 #include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
 
+#include <lm/util/arena.h>
 #include <lm/util/assert.h>
+#include <lm/util/execution.h>
+#include <lm/util/perf_counters.h>
+#include <lm/util/reduce.h>
+#include <lm/util/stats.h>
 #include <lm/matrix/type_util.h>
 #include <lm/matrix/traits.h>
+#include <lm/matrix/layout.h>
 #include <lm/matrix/permutation.h>
+#include <lm/matrix/pivoted.h>
 
 //! lm namespace
 namespace lm {
@@ -105,17 +115,31 @@ void swap_col(M& m, size_t c1, size_t c2) {
  *
  * @tparam M matrix type
  * @tparam P transposed matrix type
+ * @param policy execution policy, parallel one splits rows of result between threads
  * @param m matrix to transpose
  * @param result transposed matrix
  */
 template <typename M, typename P = typename matrix_transpose<M>::value_matrix_type>
-void transpose(const M& m, P& result) {
+void transpose(const execution_policy& policy, const M& m, P& result) {
+    LM_PERF_SCOPE("transpose", m.rows(), m.cols());
+    LM_STATS_SCOPE(transpose, m.rows(), m.cols(), 0);
     result.resize(m.cols(), m.rows());
-    for (size_t i = 0; i < result.rows(); i++) {
-        for (size_t j = 0; j < result.cols(); j++) {
-            result(i, j) = m(j, i);
+    parallel_for(policy, 0, result.rows(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            for (size_t j = 0; j < result.cols(); j++) {
+                result(i, j) = m(j, i);
+            }
         }
-    }
+    });
+}
+
+/**
+ * @brief Stores transposed matrix sequentially.
+ * @see transpose(const execution_policy&, const M&, P&)
+ */
+template <typename M, typename P = typename matrix_transpose<M>::value_matrix_type>
+void transpose(const M& m, P& result) {
+    transpose<M, P>(execution::seq, m, result);
 }
 
 /**
@@ -140,26 +164,202 @@ P transpose(const M& m) {
 }
 
 /**
- * @brief Computes product of matrix `m` and `n` and stores result in `result` matrix.
+ * @brief Hooks which compute results of dynamic matricies by fixed size kernels.
  *
- * Matrix multiplication produces a matrix of @f$ m.rows() \times n.cols() @f$ with an expectation that @f$ m.cols() = n.rows() @f$.
+ * By default nothing is computed and `compute(..)` returns `false`, specializations are in dispatch.h.
+ */
+template <typename M, typename N, typename P, typename Enable = void>
+struct fixed_size_product {
+    static bool compute(const M&, const N&, P&) {
+        return false;
+    }
+};
+
+template <typename M, typename Enable = void>
+struct fixed_size_determinant {
+    static bool compute(const M&, typename M::value_type&) {
+        return false;
+    }
+};
+
+template <typename M, typename R, typename Enable = void>
+struct fixed_size_inverse {
+    static bool compute(const M&, R&, bool&) {
+        return false;
+    }
+};
+
+/**
+ * @brief Nesting of loops over result rows `i`, result columns `j` and summation index `k`, innermost index is last.
  *
- * By default if type of matrix `m` and `n` is static then `result` matrix is also static (actual type is same as matrix `m`)
- * with dimensions `m.rows()` and `n.cols()` respectively.
- * If matrixes are static and can't be multiplied (i.e. `m.cols() != n.rows()`) then compilation error is generated.
+ * Orders starting with `k` accumulate product as sum of outer products of columns of `M` and rows of `N`.
+ */
+enum class product_order {
+    ijk,
+    ikj,
+    jki,
+    kij,
+    kji
+};
+
+/**
+ * @brief Order with lowest cost, first one on tie.
+ */
+constexpr product_order cheapest_product_order(int ijk, int ikj, int jki, int kij, int kji) {
+    product_order order = product_order::ijk;
+    int cost = ijk;
+    const int costs[] = { ikj, jki, kij, kji };
+    const product_order orders[] = { product_order::ikj, product_order::jki, product_order::kij, product_order::kji };
+    for (size_t i = 0; i < 4; i++) {
+        if (costs[i] < cost) {
+            cost = costs[i];
+            order = orders[i];
+        }
+    }
+    return order;
+}
+
+/**
+ * @brief Chooses loop nesting of product `P = M * N` for which innermost loop has fewest strided operands.
  *
- * Also its possible to specify type `P` explicitly with dynamic, or bigger-sized static matrix
- * (in this case no static checks are performed).
+ * Each order costs 2 per strided operand of innermost loop and 1 per strided operand of middle loop,
+ * order with lowest cost is used (first listed one on tie).
  *
+ * For example row major operands are multiplied in `ikj` order (rows of `N` and `P` are traversed),
+ * column major - in `jki` order (columns of `M` and `P` are traversed),
+ * row major `M` with column major `N` - in `ijk` order (dot product of row and column),
+ * column major `M` with row major `N` and `P` (i.e. @f$ A^T B @f$ computed through `transposed(a)`) - in `kij` order
+ * (rows of `A`, `N` and `P` are traversed).
+ * Static matricies are always multiplied in `ijk` order.
+ */
+template <typename M, typename N, typename P>
+struct product_loop_order {
+    // whether stepping along index is strided for operand
+    constexpr static int m_k = is_col_major<M>::value ? 1 : 0;
+    constexpr static int m_i = is_col_major<M>::value ? 0 : 1;
+    constexpr static int n_k = is_col_major<N>::value ? 0 : 1;
+    constexpr static int n_j = is_col_major<N>::value ? 1 : 0;
+    constexpr static int p_i = is_col_major<P>::value ? 0 : 1;
+    constexpr static int p_j = is_col_major<P>::value ? 1 : 0;
+
+    constexpr static int ijk_cost = 2 * (m_k + n_k) + p_j;
+    constexpr static int ikj_cost = 2 * (n_j + p_j) + m_k;
+    constexpr static int jki_cost = 2 * (m_i + p_i) + n_k;
+    constexpr static int kij_cost = 2 * (n_j + p_j) + m_i;
+    constexpr static int kji_cost = 2 * (m_i + p_i) + n_j;
+
+    // small static matricies fit in cache anyway, while sums of dot products stay in registers
+    constexpr static bool is_static = M::Rows != 0 && M::Cols != 0 && N::Cols != 0;
+
+    constexpr static product_order value = is_static
+        ? product_order::ijk
+        : cheapest_product_order(ijk_cost, ikj_cost, jki_cost, kij_cost, kji_cost);
+};
+
+/**
+ * @brief Computes rows `[begin, end)` of product `result` (columns for `jki` and `kji` orders) in given loop order.
+ *
+ * `result` must already have `m.rows()` rows and `n.cols()` columns.
+ */
+template <typename Acc, typename M, typename N, typename P>
+void product_accumulate_range(const M& m, const N& n, P& result, product_order order, size_t begin, size_t end) {
+    switch (order) {
+    case product_order::ikj:
+        for (size_t i = begin; i < end; i++) {
+            for (size_t j = 0; j < result.cols(); j++) {
+                result(i, j) = 0;
+            }
+            for (size_t k = 0; k < n.rows(); k++) {
+                const Acc a = static_cast<Acc>(m(i, k));
+                for (size_t j = 0; j < result.cols(); j++) {
+                    result(i, j) += static_cast<typename P::value_type>(a * static_cast<Acc>(n(k, j)));
+                }
+            }
+        }
+        break;
+
+    case product_order::jki:
+        for (size_t j = begin; j < end; j++) {
+            for (size_t i = 0; i < result.rows(); i++) {
+                result(i, j) = 0;
+            }
+            for (size_t k = 0; k < n.rows(); k++) {
+                const Acc b = static_cast<Acc>(n(k, j));
+                for (size_t i = 0; i < result.rows(); i++) {
+                    result(i, j) += static_cast<typename P::value_type>(static_cast<Acc>(m(i, k)) * b);
+                }
+            }
+        }
+        break;
+
+    case product_order::kij:
+    case product_order::kji: {
+        const bool split_rows = order == product_order::kij;
+        for (size_t i = split_rows ? begin : 0; i < (split_rows ? end : result.rows()); i++) {
+            for (size_t j = split_rows ? 0 : begin; j < (split_rows ? result.cols() : end); j++) {
+                result(i, j) = 0;
+            }
+        }
+        for (size_t k = 0; k < n.rows(); k++) {
+            if (split_rows) {
+                for (size_t i = begin; i < end; i++) {
+                    const Acc a = static_cast<Acc>(m(i, k));
+                    for (size_t j = 0; j < result.cols(); j++) {
+                        result(i, j) += static_cast<typename P::value_type>(a * static_cast<Acc>(n(k, j)));
+                    }
+                }
+            } else {
+                for (size_t j = begin; j < end; j++) {
+                    const Acc b = static_cast<Acc>(n(k, j));
+                    for (size_t i = 0; i < result.rows(); i++) {
+                        result(i, j) += static_cast<typename P::value_type>(static_cast<Acc>(m(i, k)) * b);
+                    }
+                }
+            }
+        }
+        break;
+    }
+
+    default:
+        for (size_t i = begin; i < end; i++) {
+            for (size_t j = 0; j < result.cols(); j++) {
+                Acc sum = 0;
+                for (size_t k = 0; k < n.rows(); k++) {
+                    sum += static_cast<Acc>(m(i, k)) * static_cast<Acc>(n(k, j));
+                }
+                result(i, j) = static_cast<typename P::value_type>(sum);
+            }
+        }
+        break;
+    }
+}
+
+/**
+ * @brief Computes product of matrix `m` and `n` accumulating sums in type `Acc` and stores result in `result` matrix.
+ *
+ * Elements are converted to `Acc` before multiplication and sums are converted to `P::value_type` when stored,
+ * so for example float matricies may be multiplied with double accumulation:
+ *
+ * @code
+ * product_accumulate<double>(m, n, result);
+ * @endcode
+ *
+ * Loop nesting is chosen by layouts of matricies (see `product_loop_order`), each sum is accumulated in same order
+ * for any nesting. If `Acc` differs from `P::value_type` sums are kept in registers, so `ijk` order is used.
+ *
+ * Parallel `policy` splits rows of result (columns for `jki` and `kji` orders) between threads.
+ *
+ * @tparam Acc accumulator type
  * @tparam M first matrix type
  * @tparam N second matrix type
  * @tparam P product matrix type
+ * @param policy execution policy
  * @param m first matrix
  * @param n second matrix
  * @param result matrix to store product of m*n
  */
-template <typename M, typename N, typename P = typename matrix_product<M, N>::value_matrix_type>
-void product(const M& m, const N& n, P& result) {
+template <typename Acc, typename M, typename N, typename P = typename matrix_product<M, N>::value_matrix_type>
+void product_accumulate(const execution_policy& policy, const M& m, const N& n, P& result) {
 
     static_assert( M::Cols == 0 || N::Rows == 0 || M::Cols == N::Rows, "matricies can't be multiplied" );
 
@@ -167,17 +367,24 @@ void product(const M& m, const N& n, P& result) {
 
     result.resize(m.rows(), n.cols());
 
-    for (size_t i = 0; i < result.rows(); i++) {
-        for (size_t j = 0; j < result.cols(); j++) {
-            typename M::value_type sum = 0;
-            for (size_t k = 0; k < n.rows(); k++) {
-                sum += m(i, k) * n(k, j);
-            }
-            result(i, j) = sum;
-        }
-    }
+    // sums are kept in result only if it has accumulator type
+    const product_order order = std::is_same<Acc, typename P::value_type>::value
+        ? product_loop_order<M, N, P>::value
+        : product_order::ijk;
+
+    const bool split_cols = order == product_order::jki || order == product_order::kji;
+    parallel_for(policy, 0, split_cols ? result.cols() : result.rows(), [&](size_t begin, size_t end) {
+        product_accumulate_range<Acc>(m, n, result, order, begin, end);
+    });
 }
 
+/**
+ * @brief Computes product of matrix `m` and `n` accumulating sums in type `Acc` sequentially.
+ */
+template <typename Acc, typename M, typename N, typename P = typename matrix_product<M, N>::value_matrix_type>
+void product_accumulate(const M& m, const N& n, P& result) {
+    product_accumulate<Acc>(execution::seq, m, n, result);
+}
 
 /**
  * @brief Computes product of matrix `m` and `n` and stores result in `result` matrix.
@@ -194,17 +401,48 @@ void product(const M& m, const N& n, P& result) {
  * @tparam M first matrix type
  * @tparam N second matrix type
  * @tparam P product matrix type
+ * @param policy execution policy, parallel one splits rows or columns of result between threads
  * @param m first matrix
  * @param n second matrix
  * @param result matrix to store product of m*n
  */
 template <typename M, typename N, typename P = typename matrix_product<M, N>::value_matrix_type>
-void product_homogeneous(const M& m, const N& n, P& result) {
+void product(const execution_policy& policy, const M& m, const N& n, P& result) {
+
+    static_assert( M::Cols == 0 || N::Rows == 0 || M::Cols == N::Rows, "matricies can't be multiplied" );
+
+    lm_assert(m.cols() == n.rows(), m.cols() << " must be equal to " << n.rows() );
+
+    LM_PERF_SCOPE("product", m.rows(), n.cols());
+    LM_STATS_SCOPE(product, m.rows(), n.cols(), 2 * m.rows() * m.cols() * n.cols());
+    if (fixed_size_product<M, N, P>::compute(m, n, result)) {
+        return;
+    }
+
+    product_accumulate<typename M::value_type, M, N, P>(policy, m, n, result);
+}
 
-//    static_assert( M::Cols == 0 || N::Rows == 0 || std::min(M::Cols, N::Cols) == std::min(N::Rows, M::Rows),
-//                   "matricies can't be multiplied" );
+/**
+ * @brief Computes product of matrix `m` and `n` sequentially and stores result in `result` matrix.
+ * @see product(const execution_policy&, const M&, const N&, P&)
+ */
+template <typename M, typename N, typename P = typename matrix_product<M, N>::value_matrix_type>
+void product(const M& m, const N& n, P& result) {
+    product<M, N, P>(execution::seq, m, n, result);
+}
 
-    typedef typename P::value_type result_value;
+
+/**
+ * @brief Computes homogeneous product of matrix `m` and `n` accumulating sums in type `Acc`.
+ *
+ * @see product_homogeneous
+ * @tparam Acc accumulator type
+ * @param m first matrix
+ * @param n second matrix
+ * @param result matrix to store product of m*n
+ */
+template <typename Acc, typename M, typename N, typename P = typename matrix_product<M, N>::value_matrix_type>
+void product_homogeneous_accumulate(const M& m, const N& n, P& result) {
 
     result.resize(std::min(m.rows(), n.rows()), std::min(m.cols(), n.cols()));
 
@@ -212,20 +450,44 @@ void product_homogeneous(const M& m, const N& n, P& result) {
 
     for (size_t i = 0; i < result.rows(); i++) {
         for (size_t j = 0; j < result.cols(); j++) {
-            result_value sum = 0;
+            Acc sum = 0;
             for (size_t k = 0; k < d; k++) {
-                sum += static_cast<result_value>(m(i, k) * n(k, j));
+                sum += static_cast<Acc>(m(i, k)) * static_cast<Acc>(n(k, j));
             }
             if (m.cols() > n.rows()) {
-                sum += static_cast<result_value>(m(i, m.cols() - 1));
+                sum += static_cast<Acc>(m(i, m.cols() - 1));
             } else if (m.cols() < n.rows()) {
-                sum += static_cast<result_value>(n(n.rows() - 1, j));
+                sum += static_cast<Acc>(n(n.rows() - 1, j));
             }
-            result(i, j) = sum;
+            result(i, j) = static_cast<typename P::value_type>(sum);
         }
     }
 }
 
+/**
+ * @brief Computes product of matrix `m` and `n` and stores result in `result` matrix.
+ *
+ * Matrix multiplication produces a matrix of @f$ m.rows() \times n.cols() @f$ with an expectation that @f$ m.cols() = n.rows() @f$.
+ *
+ * By default if type of matrix `m` and `n` is static then `result` matrix is also static (actual type is same as matrix `m`)
+ * with dimensions `m.rows()` and `n.cols()` respectively.
+ * If matrixes are static and can't be multiplied (i.e. `m.cols() != n.rows()`) then compilation error is generated.
+ *
+ * Also its possible to specify type `P` explicitly with dynamic, or bigger-sized static matrix
+ * (in this case no static checks are performed).
+ *
+ * @tparam M first matrix type
+ * @tparam N second matrix type
+ * @tparam P product matrix type
+ * @param m first matrix
+ * @param n second matrix
+ * @param result matrix to store product of m*n
+ */
+template <typename M, typename N, typename P = typename matrix_product<M, N>::value_matrix_type>
+void product_homogeneous(const M& m, const N& n, P& result) {
+    product_homogeneous_accumulate<typename P::value_type, M, N, P>(m, n, result);
+}
+
 
 /**
  * @brief Computes and returns product of matrix `m` and `n`.
@@ -253,36 +515,60 @@ P product(const M& m, const N& n) {
     return result;
 }
 
+/**
+ * @brief Computes magnitude of pivot below which matrix `m` may be treated as numerically singular.
+ *
+ * Tolerance is @f$ n \epsilon \max |m_{i,j}| @f$, i.e. rounding error which elimination may leave in place of
+ * exact zero. It is used only if passed explicitly to `lu_decomposition`, `lu_decomposition_recursive`
+ * or `invert_inplace`, by default only exact zero pivots are rejected, since tolerance relative to largest element
+ * would also reject nonsingular badly scaled matricies, e.g. @f$ diag(1, 10^{-20}) @f$. For integer elements it is zero.
+ *
+ * @param m matrix to perform LU-factorization
+ * @return tolerance of pivots
+ */
+template <typename M>
+typename M::value_type lu_pivot_tolerance(M& m) {
+    typedef typename M::value_type value_type;
+    const value_type eps = std::numeric_limits<value_type>::epsilon();
+    if (eps == 0) {
+        return eps;
+    }
+    value_type scale = 0;
+    for (size_t i = 0; i < m.rows(); i++) {
+        for (size_t j = 0; j < m.cols(); j++) {
+            scale = std::max<value_type>(scale, std::abs(m(i, j)));
+        }
+    }
+    return static_cast<value_type>(m.rows()) * eps * scale;
+}
+
 /**
  * @brief Finds the best pivoting row for more stable LU-factorization results.
  *
+ * Pivot is the element of largest magnitude (partial pivoting), so multipliers of elimination don't exceed 1
+ * by magnitude and elements of factorization don't grow.
+ *
  * @param m matrix in which pivoting row must be found
  * @param n row index to begin search
+ * @param tolerance elements of at most this magnitude are treated as zero (see `lu_pivot_tolerance`)
  * @return index of best pivot row and a `bool` flag which indicates status of operation.
  *   `true` means success and pivoting row is found
  *   `false` means there is no suitable rows to perform LU-factorization and in general - that matrix `m` is singular.
  */
 template <typename M>
-std::pair<size_t, bool> find_lu_pivot(M& m, const size_t n) {
+std::pair<size_t, bool> find_lu_pivot(M& m, const size_t n, const typename M::value_type tolerance = 0) {
 
     size_t l = m.rows();
 
     std::pair<size_t, bool> result(0, false);
+    typename M::value_type best = tolerance;
     for (size_t i = n; i < l; i++) {
 
-        const typename M::value_type v = m(i, n);
-        if (v == 0) {
-            continue;
-        }
-
-        if (!result.second) {
+        const typename M::value_type v = std::abs(m(i, n));
+        if (v > best) {
             result.first = i;
             result.second = true;
-            continue;
-        }
-
-        if (std::abs(v) < std::abs(m(result.first, n))) {
-            result.first = i;
+            best = v;
         }
 
     }
@@ -313,42 +599,109 @@ std::pair<size_t, bool> find_lu_pivot(M& m, const size_t n) {
  * \end{pmatrix}
  * @f]
  *
+ * Rows are swapped by `m.swap_row`, so to keep the permutation `m` is usually `permutation_matrix`
+ * (rows are swapped by index, each element access is indirect) or `pivoted_matrix`
+ * (rows are swapped in memory, elements are accessed directly), the latter is used by
+ * `invert_matrix`, `determinant` and `solve`.
+ *
+ * Parallel `policy` splits rows of trailing submatrix between threads on each elimination step.
+ *
+ * @param policy execution policy
  * @param m matrix to perform LU-factorization
+ * @param tolerance pivots of at most this magnitude are treated as zero, exact zero by default (see `lu_pivot_tolerance`)
  * @return `true` if LU-factorization succeds, `false` if matrix is singular and LU-factorization can't be performed
  *
  */
 template <typename M>
-bool lu_decomposition(M& m) {
+bool lu_decomposition(const execution_policy& policy, M& m, const typename M::value_type tolerance = 0) {
 
+    LM_PERF_SCOPE("lu_decomposition", m.rows(), m.cols());
+    LM_STATS_SCOPE(lu_decomposition, m.rows(), m.cols(), 2 * m.rows() * m.rows() * m.rows() / 3);
     const size_t l = m.rows();
     if (l != m.cols()) {
         throw std::invalid_argument("lu_decomposition(..) available only for square matricies");
     }
 
     for (size_t i = 0; i < l - 1; i++) {
-        std::pair<size_t, bool> pivot = find_lu_pivot(m, i);
+        std::pair<size_t, bool> pivot = find_lu_pivot(m, i, tolerance);
         if (!pivot.second) {
             return false;
         }
         m.swap_row(pivot.first, i);
-        for (size_t k = i + 1; k < l; k++) {
-            for (size_t j = i + 1; j < l; j++) {
-                m(k, j) -= m(i, j) * m(k, i) / m(i, i);
+        // pivot and multiplier are not modified by inner loop, so its accesses are direct ones only
+        const typename M::value_type d = m(i, i);
+        parallel_for(policy, i + 1, l, [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; k++) {
+                const typename M::value_type f = m(k, i);
+                for (size_t j = i + 1; j < l; j++) {
+                    m(k, j) -= m(i, j) * f / d;
+                }
+                m(k, i) = f / d;
             }
-            m(k, i) /= m(i, i);
-        }
+        });
     }
-    return m(l - 1, l - 1) != 0;
+    return std::abs(m(l - 1, l - 1)) > tolerance;
+}
+
+/**
+ * @brief Performs LU-factorization with row pivoting of a given matrix `m` sequentially.
+ * @see lu_decomposition(const execution_policy&, M&)
+ */
+template <typename M>
+bool lu_decomposition(M& m) {
+    return lu_decomposition(execution::seq, m);
 }
 
 
+/**
+ * @brief Solves columns `[begin, end)` of @f$ L U X = R @f$ in place, diagonal of `lu` must have no zeroes.
+ */
 template <typename M, typename R>
-bool lu_substitute(const M& lu, R& r) {
-    typedef typename M::value_type value_type;
-    for (size_t j = 0; j < lu.cols(); j++) {
-        if (lu(j, j) == 0) {
-            return false;
+void lu_substitute_range(const M& lu, R& r, size_t begin, size_t end) {
+    if (!is_col_major<R>::value) {
+        // whole rows of `r` are updated at once
+        for (size_t i = 1; i < lu.rows(); i++) {
+            for (size_t k = 0; k < i; k++) {
+                const typename M::value_type l = lu(i, k);
+                for (size_t j = begin; j < end; j++) {
+                    r(i, j) -= l * r(k, j);
+                }
+            }
+        }
+        for (size_t i = lu.rows() - 1; i != static_cast<size_t>(-1); i--) {
+            for (size_t k = lu.cols() - 1; k > i; k--) {
+                const typename M::value_type u = lu(i, k);
+                for (size_t j = begin; j < end; j++) {
+                    r(i, j) -= u * r(k, j);
+                }
+            }
+            const typename M::value_type d = lu(i, i);
+            for (size_t j = begin; j < end; j++) {
+                r(i, j) /= d;
+            }
+        }
+        return;
+    }
+    if (is_col_major<M>::value) {
+        // solved element of column is subtracted from remaining elements, columns of `lu` are traversed
+        for (size_t j = begin; j < end; j++) {
+            for (size_t k = 0; k < lu.rows(); k++) {
+                const typename R::value_type x = r(k, j);
+                for (size_t i = k + 1; i < lu.rows(); i++) {
+                    r(i, j) -= lu(i, k) * x;
+                }
+            }
+            for (size_t k = lu.rows() - 1; k != static_cast<size_t>(-1); k--) {
+                r(k, j) /= lu(k, k);
+                const typename R::value_type x = r(k, j);
+                for (size_t i = 0; i < k; i++) {
+                    r(i, j) -= lu(i, k) * x;
+                }
+            }
         }
+        return;
+    }
+    for (size_t j = begin; j < end; j++) {
         for (size_t i = 1; i < lu.rows();i++) {
             for (size_t k = 0; k < i; k++) {
                 r(i, j) -= lu(i, k) * r(k, j);
@@ -361,9 +714,61 @@ bool lu_substitute(const M& lu, R& r) {
             r(i, j) /= lu(i, i);
         }
     }
+}
+
+/**
+ * @brief Solves @f$ L U X = R @f$ in place by forward and backward substitution.
+ *
+ * Loops are nested by layouts of `lu` and `r`, so innermost loop traverses rows of row major `r`,
+ * columns of column major `lu` and `r`, or rows of row major `lu` otherwise.
+ * Each element receives same sequence of operations for any nesting.
+ *
+ * Columns of `r` are independent, parallel `policy` splits them between threads.
+ *
+ * @param policy execution policy
+ * @param lu LU-factorized matrix (see `lu_decomposition`)
+ * @param r right-hand side matrix with `lu.rows()` rows and any column count, receives solution
+ * @return `false` if `lu` is singular
+ */
+template <typename M, typename R>
+bool lu_substitute(const execution_policy& policy, const M& lu, R& r) {
+    LM_STATS_SCOPE(lu_substitute, lu.rows(), r.cols(), 2 * lu.rows() * lu.rows() * r.cols());
+    for (size_t i = 0; i < lu.rows(); i++) {
+        if (lu(i, i) == 0) {
+            return false;
+        }
+    }
+    parallel_for(policy, 0, r.cols(), [&](size_t begin, size_t end) {
+        lu_substitute_range(lu, r, begin, end);
+    });
     return true;
 }
 
+/**
+ * @brief Solves @f$ L U X = R @f$ in place sequentially.
+ * @see lu_substitute(const execution_policy&, const M&, R&)
+ */
+template <typename M, typename R>
+bool lu_substitute(const M& lu, R& r) {
+    return lu_substitute(execution::seq, lu, r);
+}
+
+
+/**
+ * @brief Make matrix `m` an identity matrix.
+ * @param policy execution policy, parallel one splits rows between threads
+ * @param m output matrix
+ */
+template <typename M>
+void make_identity(const execution_policy& policy, M& m) {
+    parallel_for(policy, 0, m.rows(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            for (size_t j = 0; j < m.cols(); j++) {
+                m(i, j) = static_cast<typename M::value_type>(i == j ? 1 : 0);
+            }
+        }
+    });
+}
 
 /**
  * @brief Make matrix `m` an identity matrix.
@@ -371,11 +776,81 @@ bool lu_substitute(const M& lu, R& r) {
  */
 template <typename M>
 void make_identity(M& m) {
-    for (size_t i = 0; i < m.rows(); i++) {
-        for (size_t j = 0; j < m.cols(); j++) {
-            m(i, j) = static_cast<typename M::value_type>(i == j ? 1 : 0);
+    make_identity(execution::seq, m);
+}
+
+/**
+ * @brief Computes sum of elements of matrix `m`.
+ *
+ * Rows are summed by `reproducible_sum` and sums of rows are added same way, so result is bit-identical
+ * for any `policy`, though it may differ from running sum by rounding.
+ *
+ * @tparam Acc type of accumulator
+ * @param policy execution policy, parallel one splits rows between threads
+ * @param m matrix
+ * @return sum of elements
+ */
+template <typename Acc = void, typename M,
+          typename R = typename std::conditional<std::is_void<Acc>::value, typename M::value_type, Acc>::type>
+R sum(const execution_policy& policy, const M& m) {
+    return reproducible_sum<R>(policy, m.rows(), [&](size_t i) {
+        return reproducible_sum<R>(execution::seq, m.cols(), [&](size_t j) { return m(i, j); });
+    });
+}
+
+/**
+ * @brief Computes scalar (Frobenius) product of matricies `m` and `n`, i.e. sum of products of their elements.
+ *
+ * Sum is computed in same order as by `sum`, so result is bit-identical for any `policy`.
+ *
+ * @tparam Acc type of accumulator
+ * @param policy execution policy, parallel one splits rows between threads
+ * @param m first matrix
+ * @param n second matrix of same dimensions
+ * @return sum of products of elements
+ */
+template <typename Acc = void, typename M, typename N,
+          typename R = typename std::conditional<std::is_void<Acc>::value, typename M::value_type, Acc>::type>
+R scalar_product(const execution_policy& policy, const M& m, const N& n) {
+    lm_assert(m.rows() == n.rows() && m.cols() == n.cols(),
+              m.rows() << "x" << m.cols() << " must be equal to " << n.rows() << "x" << n.cols());
+    return reproducible_sum<R>(policy, m.rows(), [&](size_t i) {
+        return reproducible_sum<R>(execution::seq, m.cols(), [&](size_t j) {
+            return static_cast<R>(m(i, j)) * static_cast<R>(n(i, j));
+        });
+    });
+}
+
+/**
+ * @brief Computes inversion matrix of `m` and stores result in matrix `r` using LU-factorized copy of type `W`.
+ *
+ * @tparam W type of temporary matrix which holds LU-factorization
+ * @param policy execution policy of factorization and substitution
+ * @param m matrix to invert
+ * @param r matrix to store inverted matrix
+ * @return `true` if inversion succeds, `false` if matrix is singular and inverted matrix can't be computed.
+ */
+template <typename W, typename M, typename R>
+bool invert_matrix_using(const execution_policy& policy, const M& m, R& r) {
+    pivoted_matrix<W> lu(m);
+    if (!lu_decomposition(policy, lu)) {
+        return false;
+    }
+    r.resize(m.rows(), m.cols());
+    for (size_t i = 0; i < r.rows(); i++) {
+        for (size_t j = 0; j < r.cols(); j++) {
+            r(i, lu.permutation_vec()[j]) = static_cast<typename M::value_type>(i == j ? 1 : 0);
         }
     }
+    return lu_substitute(policy, lu, r);
+}
+
+/**
+ * @brief Computes inversion matrix of `m` sequentially using LU-factorized copy of type `W`.
+ */
+template <typename W, typename M, typename R>
+bool invert_matrix_using(const M& m, R& r) {
+    return invert_matrix_using<W>(execution::seq, m, r);
 }
 
 /**
@@ -389,24 +864,156 @@ void make_identity(M& m) {
  * Matrix inversion is allowed only for square (`rows() == cols()`), non-singular (@f$ \det m \neq 0 @f$) matricies.
  *
  *
+ * @param policy execution policy of factorization and substitution
  * @param m matrix to invert
  * @param r matrix to store inverted matrix
  * @return `true` if inversion succeds, `false` if matrix is singular and inverted matrix can't be computed.
  */
 template <typename M, typename R>
+bool invert_matrix(const execution_policy& policy, const M& m, R& r) {
+    LM_PERF_SCOPE("invert_matrix", m.rows(), m.cols());
+    LM_STATS_SCOPE(invert_matrix, m.rows(), m.cols(), 8 * m.rows() * m.rows() * m.rows() / 3);
+    bool inverted;
+    if (fixed_size_inverse<M, R>::compute(m, r, inverted)) {
+        return inverted;
+    }
+    return invert_matrix_using<typename matrix_workspace<M>::value_matrix_type>(policy, m, r);
+}
+
+/**
+ * @brief Computes inversion matrix of `m` sequentially and stores result in matrix `r`.
+ * @see invert_matrix(const execution_policy&, const M&, R&)
+ */
+template <typename M, typename R>
 bool invert_matrix(const M& m, R& r) {
-    permutation_matrix<M> lu(m);
-    if (!lu_decomposition(lu)) {
-        return false;
+    return invert_matrix(execution::seq, m, r);
+}
+
+/**
+ * @brief Computes inversion matrix of `m` and stores result in matrix `r`, temporary memory is taken from arena `a`.
+ *
+ * @param m matrix to invert
+ * @param r matrix to store inverted matrix
+ * @param a arena for temporary matricies
+ * @return `true` if inversion succeds, `false` if matrix is singular and inverted matrix can't be computed.
+ */
+template <typename M, typename R>
+bool invert_matrix(const M& m, R& r, arena& a) {
+    LM_PERF_SCOPE("invert_matrix", m.rows(), m.cols());
+    LM_STATS_SCOPE(invert_matrix, m.rows(), m.cols(), 8 * m.rows() * m.rows() * m.rows() / 3);
+    bool inverted;
+    if (fixed_size_inverse<M, R>::compute(m, r, inverted)) {
+        return inverted;
     }
+    arena_scope scope(a);
+    return invert_matrix_using<typename matrix_workspace<M>::value_matrix_type>(m, r);
+}
+
+/**
+ * @brief Solves @f$ A X = B @f$ by LU-factorized matrix `lu` of `A` and stores `X` in matrix `r`.
+ *
+ * @param lu LU-factorized permutation or pivoted matrix (see `lu_decomposition`)
+ * @param b right-hand side matrix
+ * @param r matrix to store solution
+ * @return `false` if `lu` is singular
+ */
+template <typename M, typename B, typename R>
+bool lu_solve(const M& lu, const B& b, R& r) {
+    lm_assert(lu.rows() == b.rows(), lu.rows() << " must be equal to " << b.rows());
+    r.resize(b.rows(), b.cols());
     for (size_t i = 0; i < r.rows(); i++) {
         for (size_t j = 0; j < r.cols(); j++) {
-            r(i, lu.permutation_vec()[j]) = static_cast<typename M::value_type>(i == j ? 1 : 0);
+            r(i, j) = static_cast<typename R::value_type>(b(lu.permutation_vec()[i], j));
         }
     }
     return lu_substitute(lu, r);
 }
 
+/**
+ * @brief Solves system of linear equations @f$ A X = B @f$ and stores `X` in matrix `r`.
+ *
+ * @param a square matrix of coefficients
+ * @param b right-hand side matrix
+ * @param r matrix to store solution
+ * @return `false` if matrix `a` is singular
+ */
+template <typename M, typename B, typename R>
+bool solve(const M& a, const B& b, R& r) {
+    LM_STATS_SCOPE(solve, a.rows(), b.cols(), 2 * a.rows() * a.rows() * a.rows() / 3 + 2 * a.rows() * a.rows() * b.cols());
+    pivoted_matrix<typename matrix_workspace<M>::value_matrix_type> lu(a);
+    return lu_decomposition(lu) && lu_solve(lu, b, r);
+}
+
+/**
+ * @brief Solves system of linear equations @f$ A X = B @f$ by mixed-precision iterative refinement.
+ *
+ * Matrix `a` is factorized once in its own element type. Then on each iteration residual
+ * @f$ B - A X @f$ is computed in type `Acc`, correction is solved by the factorization
+ * and added to solution which is kept in type `Acc`.
+ *
+ * For example float matrix is factorized in float, while solution gets almost double accuracy:
+ *
+ * @code
+ * solve_refined<double>(a, b, x);
+ * @endcode
+ *
+ * @tparam Acc type of residual and solution
+ * @param a square matrix of coefficients
+ * @param b right-hand side matrix
+ * @param r matrix to store solution
+ * @param iterations maximum count of refinement iterations
+ * @return `false` if matrix `a` is singular
+ */
+template <typename Acc, typename M, typename B, typename R>
+bool solve_refined(const M& a, const B& b, R& r, size_t iterations = 3) {
+    typedef typename M::value_type value_type;
+    typedef matrix<flat_dynamic_storage<std::vector<Acc, arena_allocator<Acc>>, row_major_layout>> acc_matrix;
+    typedef matrix<flat_dynamic_storage<std::vector<value_type, arena_allocator<value_type>>, row_major_layout>> correction_matrix;
+
+    LM_STATS_SCOPE(solve, a.rows(), b.cols(), 2 * a.rows() * a.rows() * a.rows() / 3 + 2 * a.rows() * a.rows() * b.cols());
+    pivoted_matrix<typename matrix_workspace<M>::value_matrix_type> lu(a);
+    acc_matrix x;
+    if (!lu_decomposition(lu) || !lu_solve(lu, b, x)) {
+        return false;
+    }
+
+    acc_matrix residual(x.rows(), x.cols());
+    correction_matrix correction;
+    for (size_t it = 0; it < iterations; it++) {
+        for (size_t i = 0; i < x.rows(); i++) {
+            for (size_t j = 0; j < x.cols(); j++) {
+                Acc sum = static_cast<Acc>(b(i, j));
+                for (size_t k = 0; k < a.cols(); k++) {
+                    sum -= static_cast<Acc>(a(i, k)) * x(k, j);
+                }
+                residual(i, j) = sum;
+            }
+        }
+
+        lu_solve(lu, residual, correction);
+
+        bool changed = false;
+        for (size_t i = 0; i < x.rows(); i++) {
+            for (size_t j = 0; j < x.cols(); j++) {
+                const Acc c = static_cast<Acc>(correction(i, j));
+                changed = changed || x(i, j) + c != x(i, j);
+                x(i, j) += c;
+            }
+        }
+        if (!changed) {
+            break;
+        }
+    }
+
+    r.resize(x.rows(), x.cols());
+    for (size_t i = 0; i < r.rows(); i++) {
+        for (size_t j = 0; j < r.cols(); j++) {
+            r(i, j) = static_cast<typename R::value_type>(x(i, j));
+        }
+    }
+    return true;
+}
+
 /**
  * @brief Computes determinant by the given LU-factorized matrix and row permutation count.
  *
@@ -429,6 +1036,21 @@ typename M::value_type lu_determinant(const M& lu, size_t permutation_count) {
     return det;
 }
 
+/**
+ * @brief Computes determinant of a given matrix `m` using LU-factorized copy of type `W`.
+ * @tparam W type of temporary matrix which holds LU-factorization
+ * @param m matrix to compute determinant
+ * @return determinant of matrix `m`
+ */
+template <typename W, typename M>
+typename M::value_type determinant_using(const M& m) {
+    pivoted_matrix<W> lu(m);
+    if (!lu_decomposition(lu)) {
+        return 0;
+    }
+    return lu_determinant(lu, lu.permutation_count());
+}
+
 /**
  * @brief Computes determinant of a given matrix `m`.
  * @param m matrix to compute determinant
@@ -436,12 +1058,146 @@ typename M::value_type lu_determinant(const M& lu, size_t permutation_count) {
  */
 template <typename M>
 typename M::value_type determinant(const M& m) {
-    permutation_matrix<M> lu(m);
+    LM_STATS_SCOPE(determinant, m.rows(), m.cols(), 2 * m.rows() * m.rows() * m.rows() / 3);
+    typename M::value_type d;
+    if (fixed_size_determinant<M>::compute(m, d)) {
+        return d;
+    }
+    return determinant_using<typename matrix_workspace<M>::value_matrix_type>(m);
+}
+
+/**
+ * @brief Computes determinant of a given matrix `m`, temporary memory is taken from arena `a`.
+ * @param m matrix to compute determinant
+ * @param a arena for temporary matricies
+ * @return determinant of matrix `m`
+ */
+template <typename M>
+typename M::value_type determinant(const M& m, arena& a) {
+    LM_STATS_SCOPE(determinant, m.rows(), m.cols(), 2 * m.rows() * m.rows() * m.rows() / 3);
+    typename M::value_type d;
+    if (fixed_size_determinant<M>::compute(m, d)) {
+        return d;
+    }
+    arena_scope scope(a);
+    return determinant_using<typename matrix_workspace<M>::value_matrix_type>(m);
+}
+
+
+/**
+ * @brief Computes determinant of matrix `m` by LU-factorization of `m` itself.
+ *
+ * Unlike `determinant` no copy of `m` is made, so after call `m` holds its LU-factorization
+ * with rows permuted (or partially factorized matrix if it is singular).
+ *
+ * @param m matrix to compute determinant, destroyed by call
+ * @return determinant of matrix `m`
+ */
+template <typename M>
+typename M::value_type determinant_inplace(M& m) {
+    LM_STATS_SCOPE(determinant, m.rows(), m.cols(), 2 * m.rows() * m.rows() * m.rows() / 3);
+    typename pivoted_storage<M&>::reference_matrix_type lu(m);
     if (!lu_decomposition(lu)) {
         return 0;
     }
     return lu_determinant(lu, lu.permutation_count());
 }
 
+/**
+ * @brief Reorders rows of matrix `m` in place so that row `i` becomes former row `p[i]`.
+ *
+ * Each cycle of permutation is applied by row swaps, so every row is moved at most once.
+ *
+ * @param m matrix to reorder
+ * @param p permutation of row indices, e.g. `permutation_vec()` of LU-factorized matrix
+ */
+template <typename M, typename P>
+void permute_rows(M& m, const P& p) {
+    std::vector<bool, arena_allocator<bool>> done(m.rows());
+    for (size_t i = 0; i < m.rows(); i++) {
+        for (size_t j = i; !done[j]; j = p[j]) {
+            done[j] = true;
+            if (p[j] != i) {
+                m.swap_row(j, p[j]);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Solves system of linear equations @f$ A X = B @f$ in place, `a` receives its LU-factorization and `b` - solution `X`.
+ *
+ * Unlike `solve` no copies of `a` and `b` are made.
+ *
+ * @param a square matrix of coefficients, destroyed by call
+ * @param b right-hand side matrix, receives solution
+ * @return `false` if matrix `a` is singular, in which case both `a` and `b` are unspecified
+ */
+template <typename M, typename B>
+bool solve_inplace(M& a, B& b) {
+    LM_STATS_SCOPE(solve, a.rows(), b.cols(), 2 * a.rows() * a.rows() * a.rows() / 3 + 2 * a.rows() * a.rows() * b.cols());
+    lm_assert(a.rows() == b.rows(), a.rows() << " must be equal to " << b.rows());
+    typename pivoted_storage<M&>::reference_matrix_type lu(a);
+    if (!lu_decomposition(lu)) {
+        return false;
+    }
+    permute_rows(b, lu.permutation_vec());
+    return lu_substitute(lu, b);
+}
+
+/**
+ * @brief Inverts matrix `m` in place by Gauss-Jordan elimination with row pivoting.
+ *
+ * Columns of inverse are built in place of eliminated columns of `m`, so unlike `invert_matrix`
+ * neither LU-factorized copy nor separate result matrix is allocated. Pivot rows are chosen by `find_lu_pivot`
+ * and row swaps are undone as column swaps of inverse in reverse order.
+ *
+ * @param m matrix to invert, receives inverted matrix
+ * @param tolerance pivots of at most this magnitude are treated as zero, exact zero by default (see `lu_pivot_tolerance`)
+ * @return `true` if inversion succeds, `false` if matrix is singular, in which case `m` is unspecified
+ */
+template <typename M>
+bool invert_inplace(M& m, const typename M::value_type tolerance = 0) {
+    typedef typename M::value_type value_type;
+
+    LM_PERF_SCOPE("invert_matrix", m.rows(), m.cols());
+    LM_STATS_SCOPE(invert_matrix, m.rows(), m.cols(), 2 * m.rows() * m.rows() * m.rows());
+    const size_t l = m.rows();
+    if (l != m.cols()) {
+        throw std::invalid_argument("invert_inplace(..) available only for square matricies");
+    }
+
+    std::vector<size_t, arena_allocator<size_t>> pivots(l);
+    for (size_t k = 0; k < l; k++) {
+        std::pair<size_t, bool> pivot = find_lu_pivot(m, k, tolerance);
+        if (!pivot.second) {
+            return false;
+        }
+        pivots[k] = pivot.first;
+        m.swap_row(pivot.first, k);
+
+        const value_type d = m(k, k);
+        m(k, k) = 1;
+        for (size_t j = 0; j < l; j++) {
+            m(k, j) /= d;
+        }
+        for (size_t i = 0; i < l; i++) {
+            if (i == k) {
+                continue;
+            }
+            const value_type f = m(i, k);
+            m(i, k) = 0;
+            for (size_t j = 0; j < l; j++) {
+                m(i, j) -= f * m(k, j);
+            }
+        }
+    }
+
+    for (size_t k = l - 1; k != static_cast<size_t>(-1); k--) {
+        m.swap_col(k, pivots[k]);
+    }
+    return true;
+}
+
 
 }
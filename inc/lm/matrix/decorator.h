@@ -7,15 +7,29 @@
 
 namespace lm {
 
+/**
+ * @brief matrix type of decorator `D` applied to matrix `M`
+ *
+ * Decorators specialize it to collapse nested decorators, e.g. permutation of permuted matrix is single permutation.
+ */
+template <template <class> class D, typename M, typename Enable = void>
+struct decorated_matrix {
+    typedef matrix<D<M>> type;
+};
+
 /**
  * @brief base class for matrix decorators
  *
+ * `value_matrix_type` is collapsed by `decorated_matrix`, while `reference_matrix_type` always keeps decorator
+ * as it must refer to the decorated object.
  */
 template <template <class> class D, typename M>
 struct matrix_decorator {
 
     typedef typename std::remove_reference<M>::type storage_type;
-    typedef matrix<D<storage_type>> value_matrix_type;
+    // type of decorated matrix without reference and const, views of const matricies are copied to it
+    typedef typename std::remove_const<storage_type>::type value_storage_type;
+    typedef typename decorated_matrix<D, value_storage_type>::type value_matrix_type;
     typedef matrix<D<storage_type&>> reference_matrix_type;
     typedef typename storage_type::value_type value_type;
 
@@ -25,7 +39,7 @@ struct matrix_decorator {
     template <size_t R, size_t C>
     struct with_size {
         typedef typename D<
-            typename matrix_with_size<storage_type, R, C>::value_matrix_type
+            typename matrix_with_size<value_storage_type, R, C>::value_matrix_type
         >::value_matrix_type value_matrix_type;
     };
 
@@ -0,0 +1,118 @@
+/**
+ * @file
+ * @brief Dispatching of dynamic matricies with small runtime dimensions to fixed size kernels
+ *
+ * When dimensions of dynamic square matrix are within [`fixed_size_min`, `fixed_size_max`] algorithms are
+ * performed on static matricies (or static views of flat matricies) of same size,
+ * so loops have compile-time bounds and no heap memory is used for temporaries.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include <lm/matrix/algorithm.h>
+#include <lm/matrix/flat.h>
+#include <lm/matrix/static.h>
+
+namespace lm {
+
+constexpr size_t fixed_size_min = 2;
+constexpr size_t fixed_size_max = 8;
+
+/**
+ * @brief calls `f(std::integral_constant<size_t, N>())` for `N == n` if `n` is within `[N, Max]`
+ */
+template <size_t N = fixed_size_min, size_t Max = fixed_size_max, bool Empty = (N > Max)>
+struct size_dispatch {
+    /**
+     * @return `false` if `n` is out of range and `f` wasn't called
+     */
+    template <typename F>
+    static bool call(size_t n, F&& f) {
+        if (n == N) {
+            f(std::integral_constant<size_t, N>());
+            return true;
+        }
+        return size_dispatch<N + 1, Max>::call(n, std::forward<F>(f));
+    }
+};
+
+template <size_t N, size_t Max>
+struct size_dispatch<N, Max, true> {
+    template <typename F>
+    static bool call(size_t, F&&) {
+        return false;
+    }
+};
+
+/**
+ * @brief static matrix which references `R * C` elements stored at `data` with layout `L`
+ */
+template <size_t R, size_t C, typename L, typename T>
+typename static_matrix_storage<T(&)[R * C], array_matrix_traits<T, R, C, L>>::reference_matrix_type fixed_view(T* data) {
+    return typename static_matrix_storage<T(&)[R * C], array_matrix_traits<T, R, C, L>>::reference_matrix_type(
+        *reinterpret_cast<T(*)[R * C]>(data));
+}
+
+// square products of flat dynamic matricies are computed on static views
+template <typename M, typename N, typename P>
+struct fixed_size_product<M, N, P, typename std::enable_if<
+        M::Rows == 0 && N::Rows == 0 && P::Rows == 0 &&
+        flat_traits<M>::is_flat && flat_traits<N>::is_flat && flat_traits<P>::is_flat>::type> {
+
+    static bool compute(const M& m, const N& n, P& result) {
+        const size_t size = m.rows();
+        if (m.cols() != size || n.cols() != size) {
+            return false;
+        }
+        return size_dispatch<>::call(size, [&](auto s) {
+            constexpr size_t S = decltype(s)::value;
+            result.resize(S, S);
+            auto vr = fixed_view<S, S, typename flat_traits<P>::layout_type>(flat_traits<P>::data(result));
+            // views of operands are only read, also when they refer to const matricies
+            product(fixed_view<S, S, typename flat_traits<M>::layout_type>(
+                        const_cast<typename M::value_type*>(flat_traits<M>::data(m))),
+                    fixed_view<S, S, typename flat_traits<N>::layout_type>(
+                        const_cast<typename N::value_type*>(flat_traits<N>::data(n))),
+                    vr);
+        });
+    }
+};
+
+// LU-factorization of dynamic matrix is performed on static copy
+template <typename M>
+struct fixed_size_determinant<M, typename std::enable_if<M::Rows == 0 && M::Cols == 0>::type> {
+
+    static bool compute(const M& m, typename M::value_type& d) {
+        if (m.rows() != m.cols()) {
+            return false;
+        }
+        return size_dispatch<>::call(m.rows(), [&](auto s) {
+            constexpr size_t S = decltype(s)::value;
+            d = determinant_using<array_matrix<typename M::value_type, S, S>>(m);
+        });
+    }
+};
+
+template <typename M, typename R>
+struct fixed_size_inverse<M, R, typename std::enable_if<M::Rows == 0 && M::Cols == 0 && R::Rows == 0 && R::Cols == 0>::type> {
+
+    static bool compute(const M& m, R& r, bool& inverted) {
+        if (m.rows() != m.cols()) {
+            return false;
+        }
+        return size_dispatch<>::call(m.rows(), [&](auto s) {
+            constexpr size_t S = decltype(s)::value;
+            array_matrix<typename M::value_type, S, S> inv;
+            inverted = invert_matrix_using<array_matrix<typename M::value_type, S, S>>(m, inv);
+            if (inverted) {
+                r.assign(inv);
+            }
+        });
+    }
+};
+
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <lm/util/half.h>
+#include <lm/matrix/layout.h>
+
+namespace lm {
+
+/**
+ * @brief element type codes used in matrix file headers
+ */
+enum class dtype : uint32_t {
+    unknown = 0,
+    int8 = 1,
+    uint8 = 2,
+    int16 = 3,
+    uint16 = 4,
+    int32 = 5,
+    uint32 = 6,
+    int64 = 7,
+    uint64 = 8,
+    float32 = 9,
+    float64 = 10,
+    float16 = 11,
+    bfloat16 = 12
+};
+
+template <typename T>
+struct dtype_of {
+    constexpr static dtype value = dtype::unknown;
+};
+
+template <> struct dtype_of<int8_t> { constexpr static dtype value = dtype::int8; };
+template <> struct dtype_of<uint8_t> { constexpr static dtype value = dtype::uint8; };
+template <> struct dtype_of<int16_t> { constexpr static dtype value = dtype::int16; };
+template <> struct dtype_of<uint16_t> { constexpr static dtype value = dtype::uint16; };
+template <> struct dtype_of<int32_t> { constexpr static dtype value = dtype::int32; };
+template <> struct dtype_of<uint32_t> { constexpr static dtype value = dtype::uint32; };
+template <> struct dtype_of<int64_t> { constexpr static dtype value = dtype::int64; };
+template <> struct dtype_of<uint64_t> { constexpr static dtype value = dtype::uint64; };
+template <> struct dtype_of<float> { constexpr static dtype value = dtype::float32; };
+template <> struct dtype_of<double> { constexpr static dtype value = dtype::float64; };
+template <> struct dtype_of<half> { constexpr static dtype value = dtype::float16; };
+template <> struct dtype_of<bfloat16> { constexpr static dtype value = dtype::bfloat16; };
+
+/**
+ * @brief size of element of given type in bytes, `0` for unknown types
+ */
+inline size_t dtype_size(dtype type) {
+    switch (type) {
+    case dtype::int8: case dtype::uint8: return 1;
+    case dtype::int16: case dtype::uint16: case dtype::float16: case dtype::bfloat16: return 2;
+    case dtype::int32: case dtype::uint32: case dtype::float32: return 4;
+    case dtype::int64: case dtype::uint64: case dtype::float64: return 8;
+    default: return 0;
+    }
+}
+
+/**
+ * @brief layout codes used in matrix file headers
+ */
+enum class layout_code : uint32_t {
+    row_major = 0,
+    col_major = 1
+};
+
+template <typename L>
+struct layout_code_of;
+
+template <> struct layout_code_of<row_major_layout> { constexpr static layout_code value = layout_code::row_major; };
+template <> struct layout_code_of<col_major_layout> { constexpr static layout_code value = layout_code::col_major; };
+
+}
@@ -2,7 +2,9 @@
 
 #include <cstddef>
 #include <type_traits>
+#include <utility>
 
+#include <lm/util/small_vector.h>
 #include <lm/matrix/fwd.h>
 #include <lm/matrix/layout.h>
 
@@ -11,7 +13,8 @@ namespace lm {
 template <typename M, typename L = row_major_layout>
 class flat_dynamic_storage {
 public:
-    typedef typename M::value_type value_type;
+    typedef typename std::remove_reference<M>::type::value_type value_type;
+    typedef L layout_type;
 
     constexpr static size_t Rows = 0;
     constexpr static size_t Cols = 0;
@@ -22,6 +25,22 @@ public:
 
     flat_dynamic_storage() : _r(0), _c(0) {}
 
+    flat_dynamic_storage(const flat_dynamic_storage&) = default;
+    flat_dynamic_storage& operator=(const flat_dynamic_storage&) = default;
+
+    // move constructor, moved-from matrix becomes empty
+    flat_dynamic_storage(flat_dynamic_storage&& other) : _m(std::forward<M>(other._m)), _r(other._r), _c(other._c) {
+        other._r = other._c = 0;
+    }
+
+    flat_dynamic_storage& operator=(flat_dynamic_storage&& other) {
+        _m = std::forward<M>(other._m);
+        _r = other._r;
+        _c = other._c;
+        other._r = other._c = 0;
+        return *this;
+    }
+
     // initializer constructor
     template <typename T>
     flat_dynamic_storage(const std::initializer_list<std::initializer_list<T>>& m) {
@@ -38,6 +57,12 @@ public:
         resize(r, c);
     }
 
+    // adopts container
+    template <typename T = M, typename = typename std::enable_if<!std::is_reference<T>::value && std::is_same<T, M>::value>::type>
+    flat_dynamic_storage(storage_type&& m, size_t r, size_t c) : _m(std::move(m)) {
+        resize(r, c);
+    }
+
     // reference constructor
     template <typename T = M, typename = typename std::enable_if<std::is_reference<M>::value && std::is_same<T, M>::value>::type>
     flat_dynamic_storage(M m, size_t r = 0, size_t c = 0) : _m(m) {
@@ -61,7 +86,7 @@ public:
     }
 
     void swap_col(size_t c1, size_t c2) {
-        lm::swap_row(*this, c1, c2);
+        lm::swap_col(*this, c1, c2);
     }
 
     void resize(size_t rows, size_t cols) {
@@ -85,6 +110,9 @@ using flat_dynamic_matrix = typename flat_dynamic_storage<M, L>::value_matrix_ty
 template <typename T, typename L = row_major_layout>
 using vector_matrix = flat_dynamic_matrix<std::vector<T>, L>;
 
+template <typename T, size_t N = 64, typename L = row_major_layout>
+using small_matrix = flat_dynamic_matrix<small_vector<T, N>, L>;
+
 
 
 }
@@ -0,0 +1,106 @@
+/**
+ * @file
+ * @brief Native binary matrix file format
+ *
+ * Matrix file consists of 64-byte header followed by raw matrix elements.
+ * All header fields are stored in native byte order:
+ *
+ * | offset | size | field         | description                                               |
+ * |--------|------|---------------|-----------------------------------------------------------|
+ * | 0      | 4    | `magic`       | `LMMX`                                                    |
+ * | 4      | 4    | `version`     | format version, currently `1`                             |
+ * | 8      | 4    | `type`        | element type, see `lm::dtype`                             |
+ * | 12     | 4    | `layout`      | `0` - row major, `1` - column major, see `lm::layout_code` |
+ * | 16     | 8    | `rows`        | row count                                                 |
+ * | 24     | 8    | `cols`        | column count                                              |
+ * | 32     | 8    | `data_offset` | offset of first element from the beginning of file        |
+ * | 40     | 4    | `alignment`   | alignment of `data_offset`, currently `64`                |
+ * | 44     | 20   | `reserved`    | zeroes                                                    |
+ *
+ * Elements (`rows * cols` values of `type`) are stored contiguously according to `layout` starting at `data_offset`,
+ * which is always a multiple of `alignment`. Since file mappings are page-aligned,
+ * element data of a mapped file is aligned to 64 bytes too, so it may be used in-place by SIMD code.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <lm/matrix/dtype.h>
+
+namespace lm {
+
+/**
+ * @brief header of binary matrix file
+ */
+struct matrix_file_header {
+
+    constexpr static uint32_t current_version = 1;
+    constexpr static uint32_t data_alignment = 64;
+
+    char magic[4];
+    uint32_t version;
+    uint32_t type;
+    uint32_t layout;
+    uint64_t rows;
+    uint64_t cols;
+    uint64_t data_offset;
+    uint32_t alignment;
+    uint8_t reserved[20];
+
+    template <typename T, typename L>
+    static matrix_file_header make(size_t rows, size_t cols) {
+        matrix_file_header h;
+        std::memset(&h, 0, sizeof(h));
+        std::memcpy(h.magic, "LMMX", 4);
+        h.version = current_version;
+        h.type = static_cast<uint32_t>(dtype_of<T>::value);
+        h.layout = static_cast<uint32_t>(layout_code_of<L>::value);
+        h.rows = rows;
+        h.cols = cols;
+        h.alignment = data_alignment;
+        h.data_offset = (sizeof(matrix_file_header) + data_alignment - 1) / data_alignment * data_alignment;
+        return h;
+    }
+
+    /**
+     * @brief checks magic, version, layout and data placement
+     *
+     * Header is untrusted, so size of data is checked by division and can't overflow.
+     *
+     * @param file_size size of whole file in bytes
+     */
+    bool is_valid(size_t file_size) const {
+        if (std::memcmp(magic, "LMMX", 4) != 0 || version == 0 || version > current_version) {
+            return false;
+        }
+        if (layout != static_cast<uint32_t>(layout_code::row_major) && layout != static_cast<uint32_t>(layout_code::col_major)) {
+            return false;
+        }
+        if (alignment == 0 || data_offset < sizeof(matrix_file_header) || data_offset % alignment != 0
+                || data_offset > file_size) {
+            return false;
+        }
+        const size_t element_size = dtype_size(static_cast<dtype>(type));
+        if (element_size == 0) {
+            return false;
+        }
+        const uint64_t max_elements = (file_size - data_offset) / element_size;
+        return cols == 0 || rows <= max_elements / cols;
+    }
+
+    size_t data_size() const {
+        return static_cast<size_t>(rows * cols) * dtype_size(static_cast<dtype>(type));
+    }
+
+    size_t file_size() const {
+        return static_cast<size_t>(data_offset) + data_size();
+    }
+
+};
+
+static_assert(sizeof(matrix_file_header) == 64, "matrix_file_header must be 64 bytes long");
+
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include <lm/matrix/fwd.h>
+#include <lm/matrix/layout.h>
+#include <lm/matrix/type_util.h>
+
+namespace lm {
+
+template <typename M, typename MT> class static_matrix_storage;
+
+/**
+ * @brief pointer to first element of contiguous container
+ */
+template <typename C>
+auto flat_data(C& c) -> decltype(c.data()) {
+    return c.data();
+}
+
+template <typename T, size_t N>
+T* flat_data(T (&c)[N]) {
+    return c;
+}
+
+template <typename T, size_t R, size_t C>
+T* flat_data(T (&c)[R][C]) {
+    return &c[0][0];
+}
+
+/**
+ * @brief detects matricies which keep all elements in single contiguous block of memory
+ *
+ * For such matricies `is_flat` is `true`, `layout_type` is the layout of elements in memory
+ * and `data(m)` returns pointer to first element.
+ */
+template <typename M, typename Enable = void>
+struct flat_traits {
+    constexpr static bool is_flat = false;
+};
+
+template <typename C, typename L>
+struct flat_traits<matrix<flat_dynamic_storage<C, L>>,
+        typename make_void<decltype(flat_data(std::declval<typename std::remove_reference<C>::type&>()))>::type> {
+
+    constexpr static bool is_flat = true;
+    typedef L layout_type;
+
+    template <typename M>
+    static auto data(M& m) -> decltype(flat_data(m.value())) {
+        return flat_data(m.value());
+    }
+};
+
+template <typename C, typename MT>
+struct flat_traits<matrix<static_matrix_storage<C, MT>>,
+        typename make_void<typename MT::layout_type,
+            decltype(flat_data(std::declval<typename std::remove_reference<C>::type&>()))>::type> {
+
+    constexpr static bool is_flat = true;
+    typedef typename MT::layout_type layout_type;
+
+    template <typename M>
+    static auto data(M& m) -> decltype(flat_data(m.value())) {
+        return flat_data(m.value());
+    }
+};
+
+/**
+ * @brief `true` if matrix `M` is flat and its elements are stored row by row
+ */
+template <typename M, typename Enable = void>
+struct is_row_major_flat: public std::false_type {};
+
+template <typename M>
+struct is_row_major_flat<M, typename std::enable_if<
+        std::is_same<typename flat_traits<M>::layout_type, row_major_layout>::value>::type>: public std::true_type {};
+
+/**
+ * @brief pointer to first element of row major flat matrix, `nullptr` for other matricies
+ */
+template <typename M>
+auto row_major_data(M& m, typename std::enable_if<is_row_major_flat<M>::value>::type* = nullptr)
+        -> decltype(flat_traits<M>::data(m)) {
+    return flat_traits<M>::data(m);
+}
+
+template <typename M>
+typename M::value_type* row_major_data(M&, typename std::enable_if<!is_row_major_flat<M>::value>::type* = nullptr) {
+    return nullptr;
+}
+
+}
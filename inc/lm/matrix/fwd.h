@@ -3,5 +3,6 @@
 namespace lm {
 
 template <typename S> class matrix;
+template <typename M, typename L> class flat_dynamic_storage;
 
 }
@@ -0,0 +1,201 @@
+/**
+ * @file
+ * @brief Saving and loading matricies in native binary format
+ *
+ * @see file_format.h for description of file format
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+
+#include <lm/matrix/file_format.h>
+#include <lm/matrix/flat.h>
+#include <lm/matrix/mmap.h>
+
+namespace lm {
+
+/**
+ * @brief reads and writes elements of matrix `M`
+ *
+ * Elements of flat matricies are copied as a single block,
+ * elements of other matricies are copied in row major order through an intermediate buffer.
+ */
+template <typename M, bool Flat = flat_traits<M>::is_flat>
+struct binary_io {
+
+    typedef typename M::value_type value_type;
+    typedef row_major_layout layout_type;
+
+    constexpr static size_t chunk_size = 4096;
+
+    static void write(std::ostream& out, const M& m) {
+        value_type buf[chunk_size];
+        size_t n = 0;
+        for (size_t i = 0; i < m.rows(); i++) {
+            for (size_t j = 0; j < m.cols(); j++) {
+                buf[n++] = m(i, j);
+                if (n == chunk_size) {
+                    out.write(reinterpret_cast<const char*>(buf), n * sizeof(value_type));
+                    n = 0;
+                }
+            }
+        }
+        out.write(reinterpret_cast<const char*>(buf), n * sizeof(value_type));
+    }
+
+    static void read(std::istream& in, M& m, layout_code layout) {
+        const bool row_major = layout == layout_code::row_major;
+        const size_t outer = row_major ? m.rows() : m.cols();
+        const size_t inner = row_major ? m.cols() : m.rows();
+
+        value_type buf[chunk_size];
+        size_t n = 0, available = 0;
+        for (size_t i = 0; i < outer; i++) {
+            for (size_t j = 0; j < inner; j++) {
+                if (n == available) {
+                    available = std::min(chunk_size, (outer - i) * inner - j);
+                    in.read(reinterpret_cast<char*>(buf), available * sizeof(value_type));
+                    n = 0;
+                }
+                (row_major ? m(i, j) : m(j, i)) = buf[n++];
+            }
+        }
+    }
+
+};
+
+template <typename M, bool Flat> constexpr size_t binary_io<M, Flat>::chunk_size;
+
+template <typename M>
+struct binary_io<M, true> {
+
+    typedef typename M::value_type value_type;
+    typedef typename flat_traits<M>::layout_type layout_type;
+
+    static void write(std::ostream& out, const M& m) {
+        out.write(reinterpret_cast<const char*>(flat_traits<M>::data(m)), m.rows() * m.cols() * sizeof(value_type));
+    }
+
+    static void read(std::istream& in, M& m, layout_code layout) {
+        if (layout != layout_code_of<layout_type>::value) {
+            binary_io<M, false>::read(in, m, layout);
+            return;
+        }
+        in.read(reinterpret_cast<char*>(flat_traits<M>::data(m)), m.rows() * m.cols() * sizeof(value_type));
+    }
+
+};
+
+/**
+ * @brief Writes matrix `m` to stream `out` in binary format.
+ *
+ * Flat matricies are written in their own layout, other matricies - in row major layout.
+ *
+ * @param out output stream, must be opened in binary mode
+ * @param m matrix to write
+ */
+template <typename M>
+void save(std::ostream& out, const M& m) {
+    typedef typename M::value_type value_type;
+    typedef typename binary_io<M>::layout_type layout_type;
+
+    static_assert(dtype_of<value_type>::value != dtype::unknown, "element type can't be stored in matrix file");
+
+    const matrix_file_header h = matrix_file_header::make<value_type, layout_type>(m.rows(), m.cols());
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    for (size_t i = sizeof(h); i < h.data_offset; i++) {
+        out.put(0);
+    }
+    binary_io<M>::write(out, m);
+    if (!out) {
+        throw std::runtime_error("can't write matrix");
+    }
+}
+
+/**
+ * @brief Writes matrix `m` to file `path` in binary format.
+ * @param path file path
+ * @param m matrix to write
+ */
+template <typename M>
+void save(const std::string& path, const M& m) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("can't open " + path + " for writing");
+    }
+    save(out, m);
+}
+
+/**
+ * @brief Reads matrix `m` from stream `in`.
+ *
+ * Matrix `m` is resized to dimensions stored in file, element type must be same as `M::value_type`.
+ * If layout of file differs from layout of `m` elements are reordered while reading.
+ *
+ * @param in input stream, must be opened in binary mode
+ * @param m matrix to read
+ */
+template <typename M>
+void load(std::istream& in, M& m) {
+    typedef typename M::value_type value_type;
+
+    matrix_file_header h;
+    if (!in.read(reinterpret_cast<char*>(&h), sizeof(h)) || !h.is_valid(std::numeric_limits<size_t>::max())) {
+        throw std::runtime_error("not a matrix file or unsupported version");
+    }
+    if (h.type != static_cast<uint32_t>(dtype_of<value_type>::value)) {
+        throw std::runtime_error("matrix element type mismatch");
+    }
+    if ((M::Rows != 0 && h.rows != M::Rows) || (M::Cols != 0 && h.cols != M::Cols)) {
+        throw std::runtime_error("matrix dimensions mismatch");
+    }
+
+    m.resize(static_cast<size_t>(h.rows), static_cast<size_t>(h.cols));
+    in.ignore(static_cast<std::streamsize>(h.data_offset - sizeof(h)));
+    binary_io<M>::read(in, m, static_cast<layout_code>(h.layout));
+    if (!in) {
+        throw std::runtime_error("matrix file is truncated");
+    }
+}
+
+/**
+ * @brief Reads matrix `m` from file `path`.
+ * @param path file path
+ * @param m matrix to read
+ */
+template <typename M>
+void load(const std::string& path, M& m) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("can't open " + path + " for reading");
+    }
+    load(in, m);
+}
+
+/**
+ * @brief Maps matrix file `path` into memory without copying.
+ *
+ * Element type and layout of file must be same as `T` and `L`.
+ * Pages are read from disk on first access.
+ *
+ * @tparam T element type
+ * @tparam L layout
+ * @param path file path
+ * @param mode access mode
+ * @return matrix which references mapped file contents
+ */
+template <typename T, typename L = row_major_layout>
+mmap_matrix<T, L> load_view(const std::string& path, access_mode mode = access_mode::read_only) {
+    return mmap_matrix<T, L>(path, mode);
+}
+
+}
@@ -16,4 +16,20 @@ struct row_major_layout {
     }
 };
 
+/**
+ * @brief layout of transposed matrix, i.e. row major becomes column major and vice versa
+ */
+template <typename L>
+struct flipped_layout;
+
+template <>
+struct flipped_layout<row_major_layout> {
+    typedef col_major_layout type;
+};
+
+template <>
+struct flipped_layout<col_major_layout> {
+    typedef row_major_layout type;
+};
+
 }
@@ -3,7 +3,9 @@
 #include <cstddef>
 #include <stdexcept>
 #include <type_traits>
+#include <utility>
 
+#include <lm/util/arena.h>
 #include <lm/util/functional.h>
 #include <lm/matrix/algorithm.h>
 #include <lm/matrix/layout.h>
@@ -13,6 +15,7 @@
 #include <lm/matrix/dynamic.h>
 #include <lm/matrix/transpose.h>
 #include <lm/matrix/permutation.h>
+#include <lm/matrix/dispatch.h>
 
 namespace lm {
 
@@ -24,10 +27,12 @@ public:
     typedef typename S::value_matrix_type value_matrix_type;
     typedef typename S::reference_matrix_type reference_matrix_type;
     typedef matrix<S> matrix_type;
+    // `const value_type&` for read-only views
+    typedef decltype(std::declval<S&>().at(0, 0)) reference;
 
     using S::S;
 
-    value_type& cell(size_t row, size_t col) {
+    reference cell(size_t row, size_t col) {
         return S::at(row, col);
     }
 
@@ -35,7 +40,7 @@ public:
         return const_cast<matrix_type*>(this)->at(row, col);
     }
 
-    value_type& operator()(size_t row, size_t col) {
+    reference operator()(size_t row, size_t col) {
         return cell(row, col);
     }
 
@@ -50,8 +55,24 @@ public:
         return *this;
     }
 
+    // takes over storage of other value matrix
+    template <typename M = matrix_type, typename = typename std::enable_if<std::is_same<M, value_matrix_type>::value>::type>
+    matrix_type& assign(matrix_type&& other) {
+        S::operator=(std::move(other));
+        return *this;
+    }
+
+    // elements are visited in order of storage layout
     template <typename F, typename T, typename Traits = matrix_traits<T>>
     matrix_type& apply(const T& other, F func) {
+        if (is_col_major<matrix_type>::value) {
+            for (size_t j = 0; j < S::cols(); j++) {
+                for (size_t i = 0; i < S::rows(); i++) {
+                    cell(i, j) = static_cast<value_type>( func(cell(i, j), Traits::cell(other, i, j)) );
+                }
+            }
+            return *this;
+        }
         for (size_t i = 0; i < S::rows(); i++) {
             for (size_t j = 0; j < S::cols(); j++) {
                 cell(i, j) = static_cast<value_type>( func(cell(i, j), Traits::cell(other, i, j)) );
@@ -60,16 +81,45 @@ public:
         return *this;
     }
 
+    // parallel policy splits rows (columns of column major matrix) between threads, so `func` is called concurrently
+    template <typename F, typename T, typename Traits = matrix_traits<T>>
+    matrix_type& apply(const execution_policy& policy, const T& other, F func) {
+        const bool col_major = is_col_major<matrix_type>::value;
+        parallel_for(policy, 0, col_major ? S::cols() : S::rows(), [&](size_t begin, size_t end) {
+            for (size_t a = begin; a < end; a++) {
+                for (size_t b = 0; b < (col_major ? S::rows() : S::cols()); b++) {
+                    const size_t i = col_major ? b : a, j = col_major ? a : b;
+                    cell(i, j) = static_cast<value_type>( func(cell(i, j), Traits::cell(other, i, j)) );
+                }
+            }
+        });
+        return *this;
+    }
+
     template <typename T>
     matrix_type& add(const T& other) {
+        LM_STATS_SCOPE(elementwise, S::rows(), S::cols(), S::rows() * S::cols());
         return apply<std::plus<void>, T>(other, std::plus<void>());
     }
 
     template <typename T>
     matrix_type& subtract(const T& other) {
+        LM_STATS_SCOPE(elementwise, S::rows(), S::cols(), S::rows() * S::cols());
         return apply<std::minus<void>, T>(other, std::minus<void>());
     }
 
+    // new matrix with `func` applied to elements of `this` and `other`, storage of dynamic result is counted by stats
+    template <typename F, typename T>
+    value_matrix_type elementwise(const T& other, F func) const {
+        LM_STATS_SCOPE(elementwise, S::rows(), S::cols(), S::rows() * S::cols());
+        value_matrix_type r(*this);
+        if (value_matrix_type::Rows == 0) {
+            LM_STATS_ALLOCATE(S::rows() * S::cols() * sizeof(typename value_matrix_type::value_type));
+        }
+        r.template apply<F, T>(other, func);
+        return r;
+    }
+
     template <typename T>
     bool equal(const T& other) {
         if (S::rows() != other.rows() || S::cols() != other.cols()) {
@@ -103,6 +153,12 @@ public:
         return assign(p);
     }
 
+    template <typename T>
+    matrix_type& pre_product(const T& other, arena& a) {
+        arena_scope scope(a);
+        return pre_product<T, typename matrix_workspace<typename matrix_product<T, matrix_type>::value_matrix_type>::value_matrix_type>(other);
+    }
+
     template <typename T,
               typename P = typename matrix_product<matrix_type, T>::value_matrix_type>
     matrix_type& post_product(const T& other) {
@@ -111,12 +167,18 @@ public:
         return assign(p);
     }
 
-    template <typename P = typename matrix_transpose<value_matrix_type>::value_matrix_type>
+    template <typename T>
+    matrix_type& post_product(const T& other, arena& a) {
+        arena_scope scope(a);
+        return post_product<T, typename matrix_workspace<typename matrix_product<matrix_type, T>::value_matrix_type>::value_matrix_type>(other);
+    }
+
+    template <typename P = typename matrix_transpose<S>::value_matrix_type>
     void compute_transposed(P& p) const {
         lm::transpose<value_matrix_type, P>(*this, p);
     }
 
-    template <typename P = typename matrix_transpose<value_matrix_type>::value_matrix_type>
+    template <typename P = typename matrix_transpose<S>::value_matrix_type>
     P compute_transposed() const {
         return lm::transpose<value_matrix_type, P>(*this);
     }
@@ -124,6 +186,13 @@ public:
     matrix_type& transpose() {
         value_matrix_type p;
         compute_transposed(p);
+        return assign(std::move(p));
+    }
+
+    matrix_type& transpose(arena& a) {
+        arena_scope scope(a);
+        typename matrix_workspace<value_matrix_type>::value_matrix_type p;
+        compute_transposed(p);
         return assign(p);
     }
 
@@ -138,13 +207,26 @@ public:
     }
 
     template <typename T>
-    value_matrix_type operator+(const T& other) const {
-        return value_matrix_type(*this).template add<T>(other);
+    value_matrix_type operator+(const T& other) const & {
+        return elementwise<std::plus<void>, T>(other, std::plus<void>());
+    }
+
+    // rvalue value matrix: result is computed in place
+    template <typename T, typename M = matrix_type, typename = typename std::enable_if<std::is_same<M, value_matrix_type>::value>::type>
+    value_matrix_type operator+(const T& other) && {
+        add<T>(other);
+        return std::move(*this);
     }
 
     template <typename T>
-    value_matrix_type operator-(const T& other) const {
-        return value_matrix_type(*this).template subtract<T>(other);
+    value_matrix_type operator-(const T& other) const & {
+        return elementwise<std::minus<void>, T>(other, std::minus<void>());
+    }
+
+    template <typename T, typename M = matrix_type, typename = typename std::enable_if<std::is_same<M, value_matrix_type>::value>::type>
+    value_matrix_type operator-(const T& other) && {
+        subtract<T>(other);
+        return std::move(*this);
     }
 
     template <typename T, typename P = typename matrix_product<value_matrix_type, T>::value_matrix_type>
@@ -169,6 +251,16 @@ public:
         if (!inverse(inv)) {
             return false;
         }
+        assign(std::move(inv));
+        return true;
+    }
+
+    bool invert(arena& a) {
+        arena_scope scope(a);
+        typename matrix_workspace<value_matrix_type>::value_matrix_type inv;
+        if (!invert_matrix(*this, inv, a)) {
+            return false;
+        }
         assign(inv);
         return true;
     }
@@ -196,6 +288,10 @@ public:
         return lm::determinant(*this);
     }
 
+    value_type determinant(arena& a) const {
+        return lm::determinant(*this, a);
+    }
+
 };
 
 
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <lm/util/assert.h>
+#include <lm/util/mapped_file.h>
+#include <lm/matrix/file_format.h>
+#include <lm/matrix/flat.h>
+#include <lm/matrix/layout.h>
+#include <lm/matrix/matrix.h>
+
+namespace lm {
+
+/**
+ * @brief matrix storage backed by memory-mapped file
+ *
+ * Pages are loaded by the kernel on first access, so matricies larger than available RAM can be processed
+ * by any generic algorithm. Mapped matricies can't be resized, computations which produce new matricies
+ * use in-memory `vector_matrix` with same layout.
+ *
+ * @tparam T element type
+ * @tparam L layout of elements in file
+ */
+template <typename T, typename L = row_major_layout>
+class mmap_storage {
+public:
+    static_assert(dtype_of<T>::value != dtype::unknown, "element type can't be stored in matrix file");
+
+    typedef T value_type;
+    typedef L layout_type;
+
+    constexpr static size_t Rows = 0;
+    constexpr static size_t Cols = 0;
+
+    typedef matrix<flat_dynamic_storage<std::vector<T>, L>> value_matrix_type;
+    typedef matrix<mmap_storage<T, L>> reference_matrix_type;
+
+    mmap_storage() : _data(nullptr), _r(0), _c(0) {}
+
+    // opens existing matrix file
+    explicit mmap_storage(const std::string& path, access_mode mode = access_mode::read_only) : _file(path, mode) {
+        attach(path);
+    }
+
+    // creates new matrix file
+    mmap_storage(const std::string& path, size_t rows, size_t cols) :
+        _file(path, matrix_file_header::make<T, L>(rows, cols).file_size())
+    {
+        const matrix_file_header h = matrix_file_header::make<T, L>(rows, cols);
+        std::memcpy(_file.data(), &h, sizeof(h));
+        attach(path);
+    }
+
+    size_t rows() const {
+        return _r;
+    }
+
+    size_t cols() const {
+        return _c;
+    }
+
+    value_type& at(size_t row, size_t col) {
+        return _data[L::compute_flat_index(row, col, _r, _c)];
+    }
+
+    void swap_row(size_t r1, size_t r2) {
+        lm::swap_row(*this, r1, r2);
+    }
+
+    void swap_col(size_t c1, size_t c2) {
+        lm::swap_col(*this, c1, c2);
+    }
+
+    void resize(size_t rows, size_t cols) {
+        lm_assert( rows == _r && cols == _c, "mapped matricies can't be resized" );
+    }
+
+    /**
+     * @brief gives kernel a hint about expected access pattern of whole matrix
+     */
+    void advise(access_pattern pattern) const {
+        advise(pattern, 0, _r * _c);
+    }
+
+    /**
+     * @brief gives kernel a hint about expected access pattern of `count` elements starting at flat index `first`
+     */
+    void advise(access_pattern pattern, size_t first, size_t count) const {
+        _file.advise(pattern, data_offset() + first * sizeof(T), count * sizeof(T));
+    }
+
+    void sync() const {
+        _file.sync();
+    }
+
+    const value_type* data() const { return _data; }
+    value_type* data() { return _data; }
+
+    const mapped_file& file() const { return _file; }
+
+private:
+
+    size_t data_offset() const {
+        return static_cast<size_t>(reinterpret_cast<char*>(_data) - static_cast<char*>(_file.data()));
+    }
+
+    void attach(const std::string& path) {
+        if (_file.size() < sizeof(matrix_file_header)) {
+            throw std::runtime_error(path + " is not a matrix file");
+        }
+
+        matrix_file_header h;
+        std::memcpy(&h, _file.data(), sizeof(h));
+        if (!h.is_valid(_file.size())) {
+            throw std::runtime_error(path + " is not a matrix file, has unsupported version or is truncated");
+        }
+        if (h.type != static_cast<uint32_t>(dtype_of<T>::value)) {
+            throw std::runtime_error(path + " element type mismatch");
+        }
+        if (h.layout != static_cast<uint32_t>(layout_code_of<L>::value)) {
+            throw std::runtime_error(path + " layout mismatch");
+        }
+
+        _data = reinterpret_cast<T*>(static_cast<char*>(_file.data()) + h.data_offset);
+        _r = static_cast<size_t>(h.rows);
+        _c = static_cast<size_t>(h.cols);
+    }
+
+    mapped_file _file;
+    T* _data;
+    size_t _r, _c;
+
+};
+
+template <typename T, typename L>
+struct flat_traits<matrix<mmap_storage<T, L>>> {
+
+    constexpr static bool is_flat = true;
+    typedef L layout_type;
+
+    template <typename M>
+    static auto data(M& m) -> decltype(m.data()) {
+        return m.data();
+    }
+};
+
+template <typename T, typename L = row_major_layout>
+using mmap_matrix = typename mmap_storage<T, L>::reference_matrix_type;
+
+}
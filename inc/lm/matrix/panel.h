@@ -0,0 +1,316 @@
+/**
+ * @file
+ * @brief Out-of-core matrix product over row panels
+ *
+ * When left operand of product doesn't fit in memory, it may be read by row panels (blocks of consecutive rows)
+ * from any panel source. Each panel is multiplied by right operand and the resulting rows are passed to a sink.
+ * Next panel is read on a background thread while current one is multiplied.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <future>
+#include <istream>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include <unistd.h>
+
+#include <lm/matrix/file_format.h>
+#include <lm/matrix/flat.h>
+#include <lm/matrix/matrix.h>
+#include <lm/matrix/mmap.h>
+
+namespace lm {
+
+/**
+ * @brief panel source which copies rows of in-memory (or memory-mapped) matrix `M`
+ *
+ * Every panel source provides:
+ *  - `value_type` typedef
+ *  - `rows()` and `cols()` - dimensions of whole matrix
+ *  - `read(first, count, panel)` - resizes `panel` to `count` rows and fills it with rows starting at `first`.
+ *    Calls are always sequential, but may be performed from another thread.
+ */
+template <typename M>
+class matrix_panel_source {
+public:
+    typedef typename M::value_type value_type;
+
+    explicit matrix_panel_source(const M& m) : _m(m) {}
+
+    size_t rows() const { return _m.rows(); }
+    size_t cols() const { return _m.cols(); }
+
+    template <typename P>
+    void read(size_t first, size_t count, P& panel) {
+        panel.resize(count, _m.cols());
+        for (size_t i = 0; i < count; i++) {
+            for (size_t j = 0; j < _m.cols(); j++) {
+                panel(i, j) = _m(first + i, j);
+            }
+        }
+    }
+
+private:
+    const M& _m;
+};
+
+/**
+ * @brief mapped row major matrix: rows are copied as a single block
+ *
+ * If `release_pages` is set, pages which were entirely copied are released with `access_pattern::dont_need`,
+ * so resident memory of long sequential products stays bounded. Pages are released only for `read_write`
+ * (shared) mappings: releasing pages of `read_only` (private, copy-on-write) mapping would discard changes
+ * made to matrix in memory.
+ */
+template <typename T>
+class matrix_panel_source<matrix<mmap_storage<T, row_major_layout>>> {
+public:
+    typedef T value_type;
+
+    explicit matrix_panel_source(const mmap_matrix<T, row_major_layout>& m, bool release_pages = false) :
+        _m(m), _release(release_pages && m.file().mode() == access_mode::read_write), _released(0)
+    {
+        _m.advise(access_pattern::sequential);
+    }
+
+    size_t rows() const { return _m.rows(); }
+    size_t cols() const { return _m.cols(); }
+
+    template <typename P>
+    void read(size_t first, size_t count, P& panel) {
+        panel.resize(count, _m.cols());
+        const T* src = _m.data() + first * _m.cols();
+        T* dst = row_major_data(panel);
+        if (dst != nullptr) {
+            std::memcpy(dst, src, count * _m.cols() * sizeof(T));
+        } else {
+            for (size_t i = 0; i < count; i++) {
+                for (size_t j = 0; j < _m.cols(); j++) {
+                    panel(i, j) = src[i * _m.cols() + j];
+                }
+            }
+        }
+        if (_release) {
+            release(first + count);
+        }
+    }
+
+private:
+
+    // releases pages which lie entirely before row `end`, last page of file is released with last row
+    void release(size_t end) {
+        const mapped_file& file = _m.file();
+        const size_t offset = static_cast<size_t>(reinterpret_cast<const char*>(_m.data() + end * _m.cols())
+            - static_cast<const char*>(file.data()));
+        const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        const size_t aligned = end == _m.rows() ? file.size() : offset - offset % page;
+        if (aligned > _released) {
+            file.advise(access_pattern::dont_need, _released, aligned - _released);
+            _released = aligned;
+        }
+    }
+
+    const mmap_matrix<T, row_major_layout>& _m;
+    const bool _release;
+
+    // bytes of mapping which are already released, multiple of page size until the end of file
+    size_t _released;
+};
+
+/**
+ * @brief panel source which sequentially reads row major binary matrix file (see file_format.h) from stream
+ */
+template <typename T>
+class stream_panel_source {
+public:
+    typedef T value_type;
+
+    explicit stream_panel_source(std::istream& in) : _in(in) {
+        if (!_in.read(reinterpret_cast<char*>(&_h), sizeof(_h)) || !_h.is_valid(std::numeric_limits<size_t>::max())) {
+            throw std::runtime_error("not a matrix file or unsupported version");
+        }
+        if (_h.type != static_cast<uint32_t>(dtype_of<T>::value) ||
+            _h.layout != static_cast<uint32_t>(layout_code::row_major)) {
+            throw std::runtime_error("panel source requires row major matrix of same element type");
+        }
+        _in.ignore(static_cast<std::streamsize>(_h.data_offset - sizeof(_h)));
+    }
+
+    size_t rows() const { return static_cast<size_t>(_h.rows); }
+    size_t cols() const { return static_cast<size_t>(_h.cols); }
+
+    template <typename P>
+    void read(size_t first, size_t count, P& panel) {
+        panel.resize(count, cols());
+        T* dst = row_major_data(panel);
+        if (dst != nullptr) {
+            _in.read(reinterpret_cast<char*>(dst), static_cast<std::streamsize>(count * cols() * sizeof(T)));
+        } else {
+            for (size_t i = 0; i < count; i++) {
+                for (size_t j = 0; j < cols(); j++) {
+                    _in.read(reinterpret_cast<char*>(&panel(i, j)), sizeof(T));
+                }
+            }
+        }
+        if (!_in) {
+            throw std::runtime_error("matrix file is truncated");
+        }
+    }
+
+private:
+    std::istream& _in;
+    matrix_file_header _h;
+};
+
+/**
+ * @brief sink which stores product rows into matrix `M`
+ */
+template <typename M>
+class matrix_panel_sink {
+public:
+    explicit matrix_panel_sink(M& m) : _m(m) {}
+
+    template <typename P>
+    void operator()(size_t first, const P& panel) {
+        for (size_t i = 0; i < panel.rows(); i++) {
+            for (size_t j = 0; j < panel.cols(); j++) {
+                _m(first + i, j) = panel(i, j);
+            }
+        }
+    }
+
+private:
+    M& _m;
+};
+
+template <typename M>
+matrix_panel_sink<M> make_panel_sink(M& m) {
+    return matrix_panel_sink<M>(m);
+}
+
+/**
+ * @brief iterates over row panels of source, reading next panel on background thread
+ *
+ * @tparam Source panel source type
+ * @tparam P panel matrix type
+ */
+template <typename Source, typename P = vector_matrix<typename Source::value_type>>
+class panel_reader {
+public:
+
+    panel_reader(Source& source, size_t panel_rows) : _source(source), _panel_rows(panel_rows), _next_row(0) {
+        lm_assert(panel_rows > 0, "panel must contain at least one row");
+        prefetch();
+    }
+
+    panel_reader(const panel_reader&) = delete;
+    panel_reader& operator=(const panel_reader&) = delete;
+
+    ~panel_reader() {
+        if (_pending.valid()) {
+            _pending.wait();
+        }
+    }
+
+    /**
+     * @brief swaps next panel into `panel` and starts reading the following one
+     * @param panel receives next panel, its previous buffer is reused for reading
+     * @param first receives index of first row of panel in source
+     * @return `false` if there is no more panels
+     */
+    bool next(P& panel, size_t& first) {
+        if (!_pending.valid()) {
+            return false;
+        }
+        _pending.get();
+        std::swap(panel, _next);
+        first = _next_first;
+        prefetch();
+        return true;
+    }
+
+private:
+
+    void prefetch() {
+        if (_next_row >= _source.rows()) {
+            return;
+        }
+        _next_first = _next_row;
+        const size_t count = std::min(_panel_rows, _source.rows() - _next_row);
+        _next_row += count;
+        _pending = std::async(std::launch::async, [this, count]() {
+            _source.read(_next_first, count, _next);
+        });
+    }
+
+    Source& _source;
+    size_t _panel_rows;
+    size_t _next_row;
+    size_t _next_first;
+    P _next;
+    std::future<void> _pending;
+};
+
+/**
+ * @brief Computes row count of panel so that streaming product fits into memory budget.
+ *
+ * Streaming product keeps two panels of left operand (current and prefetched) and one panel of result.
+ *
+ * @param cols column count of left operand
+ * @param result_cols column count of result (right operand)
+ * @param element_size size of matrix element
+ * @param memory_budget memory budget in bytes
+ * @return panel row count
+ * @throws std::invalid_argument if budget is too small even for a single row
+ */
+inline size_t panel_rows_for_budget(size_t cols, size_t result_cols, size_t element_size, size_t memory_budget) {
+    const size_t row_size = (2 * cols + result_cols) * element_size;
+    if (row_size == 0 || memory_budget < row_size) {
+        throw std::invalid_argument("memory budget is too small for a single row panel");
+    }
+    return memory_budget / row_size;
+}
+
+/**
+ * @brief Computes product of matrix read by row panels from `source` and in-memory matrix `n`.
+ *
+ * For each row panel @f$ A_p @f$ of source this computes @f$ C_p = A_p * N @f$ and passes it to `sink` as `sink(first_row, C_p)`.
+ * Panels are passed to sink in order. While @f$ C_p @f$ is computed next panel is read on background thread.
+ *
+ * Memory used for panels (not counting matrix `n`) doesn't exceed `memory_budget` bytes.
+ *
+ * @param source panel source of left operand
+ * @param n right operand
+ * @param sink callable which receives product rows
+ * @param memory_budget memory budget in bytes
+ */
+template <typename Source, typename N, typename Sink>
+void stream_product(Source& source, const N& n, Sink sink, size_t memory_budget) {
+    typedef typename Source::value_type value_type;
+
+    lm_assert(source.cols() == n.rows(), source.cols() << " must be equal to " << n.rows() );
+
+    const size_t panel_rows = std::min(source.rows(),
+        panel_rows_for_budget(source.cols(), n.cols(), sizeof(value_type), memory_budget));
+    if (panel_rows == 0) {
+        return;
+    }
+
+    panel_reader<Source> reader(source, panel_rows);
+
+    vector_matrix<value_type> panel;
+    vector_matrix<value_type> result;
+    size_t first;
+    while (reader.next(panel, first)) {
+        product(panel, n, result);
+        sink(first, result);
+    }
+}
+
+}
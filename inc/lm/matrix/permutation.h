@@ -3,6 +3,7 @@
 #include <cstddef>
 
 #include <numeric>
+#include <utility>
 #include <vector>
 
 #include <lm/vec/vec_traits.h>
@@ -39,6 +40,12 @@ public:
         reset();
     }
 
+    // takes over underlying matrix
+    template <typename T = M, typename = typename std::enable_if<!std::is_reference<T>::value && std::is_same<T, M>::value>::type>
+    permutation_storage(storage_type&& other) : _m(std::move(other)) {
+        reset();
+    }
+
     template <typename T = M, typename = typename std::enable_if<std::is_reference<T>::value && std::is_same<T, M>::value>::type>
     permutation_storage(M ref) : _m(ref) {
         reset();
@@ -68,7 +75,7 @@ public:
 
     void swap_col(size_t c1, size_t c2) {
         for (size_t i = 0; i < rows(); i++) {
-            std::swap(_m.at(_p[i], c1), _m.at(_p[i], c1));
+            std::swap(_m.at(_p[i], c1), _m.at(_p[i], c2));
         }
     }
 
@@ -97,6 +104,17 @@ private:
 
 };
 
+// permutation of permuted matrix is single permutation of underlying matrix
+template <typename M>
+struct decorated_matrix<permutation_storage, matrix<permutation_storage<M>>> {
+    typedef typename decorated_matrix<permutation_storage, typename std::remove_reference<M>::type>::type type;
+};
+
+template <typename M>
+struct matrix_layout<matrix<permutation_storage<M>>> {
+    typedef typename matrix_layout<typename std::remove_reference<M>::type>::type type;
+};
+
 template <typename M> using permutation_matrix = typename permutation_storage<M>::value_matrix_type;
 
 
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstddef>
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include <lm/vec/vec_traits.h>
+#include <lm/matrix/decorator.h>
+#include <lm/matrix/flat.h>
+
+namespace lm {
+
+/**
+ * @brief matrix which swaps its rows physically and records permutation of rows
+ *
+ * Unlike `permutation_storage` elements are accessed without indirection, so LU-factorization doesn't
+ * pay an extra load per operation, while each row swap costs `cols()` element swaps
+ * (swap of contiguous memory ranges for row major flat matricies).
+ *
+ * Interface of permutation is same as of `permutation_storage`: `permutation_vec()[i]` is index of original row
+ * which is now stored in row `i` and `permutation_count()` is count of performed swaps.
+ */
+template <typename M>
+class pivoted_storage: public matrix_decorator<pivoted_storage, M> {
+public:
+    typedef matrix_decorator<::lm::pivoted_storage, M> base_type;
+    typedef typename base_type::value_type value_type;
+    typedef typename base_type::storage_type storage_type;
+
+    typedef typename std::conditional<base_type::Rows == 0,
+        vec_traits<std::vector<size_t>>,
+        vec_traits<size_t[ base_type::Rows ]> >::type pm_traits;
+    typedef typename pm_traits::type pm;
+
+    pivoted_storage()  {
+        reset();
+    }
+
+    template <typename T>
+    pivoted_storage(const std::initializer_list<std::initializer_list<T>>& other) : _m(other) {
+        reset();
+    }
+
+    template <typename T> pivoted_storage(const std::initializer_list<T>& other) : _m(other) {
+        reset();
+    }
+
+    template <typename T> pivoted_storage(const T& other) : _m(other) {
+        reset();
+    }
+
+    // takes over underlying matrix
+    template <typename T = M, typename = typename std::enable_if<!std::is_reference<T>::value && std::is_same<T, M>::value>::type>
+    pivoted_storage(storage_type&& other) : _m(std::move(other)) {
+        reset();
+    }
+
+    template <typename T = M, typename = typename std::enable_if<std::is_reference<T>::value && std::is_same<T, M>::value>::type>
+    pivoted_storage(M ref) : _m(ref) {
+        reset();
+    }
+
+    size_t rows() const { return _m.rows(); }
+    size_t cols() const { return _m.cols(); }
+
+    value_type& at(size_t row, size_t col) {
+        return _m.at(row, col);
+    }
+
+    void resize(size_t r, size_t c) {
+        if (r == rows() && c == cols()) {
+            return;
+        }
+        _m.resize(r, c);
+        reset();
+    }
+
+    void swap_row(size_t r1, size_t r2) {
+        if (r1 == r2) {
+            return;
+        }
+        swap_elements(r1, r2);
+        std::swap(_p[r1], _p[r2]);
+        ++_c;
+    }
+
+    void swap_col(size_t c1, size_t c2) {
+        _m.swap_col(c1, c2);
+    }
+
+    void reset() {
+        _c = 0;
+        pm_traits::resize(_p, rows());
+        std::iota(std::begin(_p), std::end(_p), 0);
+    }
+
+    size_t permutation_count() const {
+        return _c;
+    }
+
+    const pm& permutation_vec() const {
+        return _p;
+    }
+
+    const storage_type& value() const { return _m; }
+    storage_type& value() { return _m; }
+
+private:
+
+    template <typename T = storage_type>
+    void swap_elements(size_t r1, size_t r2, typename std::enable_if<is_row_major_flat<T>::value>::type* = nullptr) {
+        value_type* data = flat_traits<T>::data(_m);
+        std::swap_ranges(data + r1 * cols(), data + (r1 + 1) * cols(), data + r2 * cols());
+    }
+
+    template <typename T = storage_type>
+    void swap_elements(size_t r1, size_t r2, typename std::enable_if<!is_row_major_flat<T>::value>::type* = nullptr) {
+        _m.swap_row(r1, r2);
+    }
+
+    M _m;
+    pm _p;
+    size_t _c;
+
+};
+
+template <typename M>
+struct matrix_layout<matrix<pivoted_storage<M>>> {
+    typedef typename matrix_layout<typename std::remove_reference<M>::type>::type type;
+};
+
+// rows of pivoted flat matrix are swapped in place, so it stays flat
+template <typename M>
+struct flat_traits<matrix<pivoted_storage<M>>,
+        typename std::enable_if<flat_traits<typename std::remove_reference<M>::type>::is_flat>::type> {
+
+    typedef flat_traits<typename std::remove_reference<M>::type> storage_traits;
+
+    constexpr static bool is_flat = true;
+    typedef typename storage_traits::layout_type layout_type;
+
+    template <typename T>
+    static auto data(T& m) -> decltype(storage_traits::data(m.value())) {
+        return storage_traits::data(m.value());
+    }
+};
+
+template <typename M> using pivoted_matrix = typename pivoted_storage<M>::value_matrix_type;
+
+
+}
@@ -0,0 +1,361 @@
+/**
+ * @file
+ * @brief Quantized integer matricies
+ *
+ * Each element of quantized matrix is a small integer `q` which represents real value @f$ s (q - z) @f$,
+ * where scale `s` and zero point `z` are stored per row or per column.
+ *
+ * Product of matrix quantized per row and matrix quantized per column is computed with integer accumulation:
+ *
+ * @f$ C_{i,j} = s_i s_j \sum_k (a_{i,k} - z_i)(b_{k,j} - z_j) =
+ *     s_i s_j \left( \sum_k a_{i,k} b_{k,j} - z_j \sum_k a_{i,k} - z_i \sum_k b_{k,j} + K z_i z_j \right) @f$
+ *
+ * so integer dot products are computed on raw values and zero points are applied once per element of result.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include <lm/util/assert.h>
+#include <lm/matrix/flat.h>
+#include <lm/matrix/matrix.h>
+
+namespace lm {
+
+/**
+ * @brief dimension along which quantization parameters are stored
+ */
+enum class quantization_axis {
+    row,
+    col
+};
+
+/**
+ * @brief storage of quantized matrix, raw values are stored in row major order
+ *
+ * `at(row, col)` returns raw integer value, `dequantized(row, col)` - real value.
+ *
+ * @tparam T integer type of raw values
+ * @tparam Axis dimension along which scale and zero point are stored
+ */
+template <typename T, quantization_axis Axis = quantization_axis::row>
+class quantized_storage {
+public:
+
+    static_assert(std::is_integral<T>::value && sizeof(T) <= 2, "quantized values must be 8 or 16 bit integers");
+
+    typedef T value_type;
+    typedef row_major_layout layout_type;
+
+    constexpr static size_t Rows = 0;
+    constexpr static size_t Cols = 0;
+
+    typedef std::vector<T> storage_type;
+    typedef matrix<quantized_storage<T, Axis>> value_matrix_type;
+    // quantized matricies are never referenced
+    typedef value_matrix_type reference_matrix_type;
+
+    quantized_storage() : _r(0), _c(0) {}
+
+    quantized_storage(size_t r, size_t c) : _r(0), _c(0) {
+        resize(r, c);
+    }
+
+    size_t rows() const {
+        return _r;
+    }
+
+    size_t cols() const {
+        return _c;
+    }
+
+    value_type& at(size_t row, size_t col) {
+        return _m[row * _c + col];
+    }
+
+    /**
+     * @brief resizes matrix, scales of new rows (or columns) are `1`, zero points - `0`
+     */
+    void resize(size_t rows, size_t cols) {
+        _m.resize(rows * cols);
+        _r = rows;
+        _c = cols;
+        _scale.resize(Axis == quantization_axis::row ? rows : cols, 1.f);
+        _zero_point.resize(_scale.size(), 0);
+    }
+
+    void swap_row(size_t r1, size_t r2) {
+        lm::swap_row(*this, r1, r2);
+        if (Axis == quantization_axis::row) {
+            std::swap(_scale[r1], _scale[r2]);
+            std::swap(_zero_point[r1], _zero_point[r2]);
+        }
+    }
+
+    void swap_col(size_t c1, size_t c2) {
+        lm::swap_col(*this, c1, c2);
+        if (Axis == quantization_axis::col) {
+            std::swap(_scale[c1], _scale[c2]);
+            std::swap(_zero_point[c1], _zero_point[c2]);
+        }
+    }
+
+    /**
+     * @brief scale of row (or column) `i`
+     */
+    float scale(size_t i) const {
+        return _scale[i];
+    }
+
+    /**
+     * @brief zero point of row (or column) `i`
+     */
+    int32_t zero_point(size_t i) const {
+        return _zero_point[i];
+    }
+
+    void set_quantization(size_t i, float scale, int32_t zero_point) {
+        _scale[i] = scale;
+        _zero_point[i] = zero_point;
+    }
+
+    /**
+     * @brief real value of element
+     */
+    float dequantized(size_t row, size_t col) const {
+        const size_t i = Axis == quantization_axis::row ? row : col;
+        return _scale[i] * static_cast<float>(static_cast<int32_t>(_m[row * _c + col]) - _zero_point[i]);
+    }
+
+    const storage_type& value() const { return _m; }
+    storage_type& value() { return _m; }
+
+private:
+    storage_type _m;
+    size_t _r, _c;
+    std::vector<float> _scale;
+    std::vector<int32_t> _zero_point;
+
+};
+
+template <typename T, quantization_axis Axis = quantization_axis::row>
+using quantized_matrix = typename quantized_storage<T, Axis>::value_matrix_type;
+
+template <typename T, quantization_axis Axis>
+struct flat_traits<matrix<quantized_storage<T, Axis>>> {
+
+    constexpr static bool is_flat = true;
+    typedef row_major_layout layout_type;
+
+    template <typename M>
+    static auto data(M& m) -> decltype(m.value().data()) {
+        return m.value().data();
+    }
+};
+
+/**
+ * @brief Quantizes matrix `m` into `q` using asymmetric quantization.
+ *
+ * For each row (or column) range of values (extended to include `0`) is mapped onto whole range of `T`.
+ *
+ * @param m matrix of real values
+ * @param q quantized matrix
+ */
+template <typename M, typename T, quantization_axis Axis>
+void quantize(const M& m, matrix<quantized_storage<T, Axis>>& q) {
+    const int32_t qmin = std::numeric_limits<T>::min();
+    const int32_t qmax = std::numeric_limits<T>::max();
+
+    q.resize(m.rows(), m.cols());
+
+    const bool by_row = Axis == quantization_axis::row;
+    const size_t outer = by_row ? m.rows() : m.cols();
+    const size_t inner = by_row ? m.cols() : m.rows();
+
+    for (size_t i = 0; i < outer; i++) {
+        float lo = 0, hi = 0;
+        for (size_t j = 0; j < inner; j++) {
+            const float v = static_cast<float>(by_row ? m(i, j) : m(j, i));
+            lo = std::min(lo, v);
+            hi = std::max(hi, v);
+        }
+
+        const float scale = hi > lo ? (hi - lo) / static_cast<float>(qmax - qmin) : 1.f;
+        const int32_t zero_point = std::max(qmin, std::min(qmax,
+            static_cast<int32_t>(std::lround(static_cast<float>(qmin) - lo / scale))));
+        q.set_quantization(i, scale, zero_point);
+
+        for (size_t j = 0; j < inner; j++) {
+            const float v = static_cast<float>(by_row ? m(i, j) : m(j, i));
+            const int32_t r = static_cast<int32_t>(std::lround(v / scale)) + zero_point;
+            (by_row ? q(i, j) : q(j, i)) = static_cast<T>(std::max(qmin, std::min(qmax, r)));
+        }
+    }
+}
+
+/**
+ * @brief Stores real values of quantized matrix `q` in matrix `m`.
+ * @param q quantized matrix
+ * @param m matrix to store real values
+ */
+template <typename T, quantization_axis Axis, typename M>
+void dequantize(const matrix<quantized_storage<T, Axis>>& q, M& m) {
+    m.resize(q.rows(), q.cols());
+    for (size_t i = 0; i < m.rows(); i++) {
+        for (size_t j = 0; j < m.cols(); j++) {
+            m(i, j) = static_cast<typename M::value_type>(q.dequantized(i, j));
+        }
+    }
+}
+
+/**
+ * @brief Computes dot product of `n` integers with `int32_t` accumulation.
+ *
+ * Sum must fit into `int32_t`, i.e. `n` up to @f$ 2^{17} @f$ for 8-bit values and only a couple of terms
+ * for full range 16-bit values, use `dot_i64` for longer ones.
+ */
+template <typename T, typename U>
+int32_t dot_i32(const T* a, const U* b, size_t n) {
+    int32_t sum = 0;
+    for (size_t i = 0; i < n; i++) {
+        sum += static_cast<int32_t>(a[i]) * static_cast<int32_t>(b[i]);
+    }
+    return sum;
+}
+
+#if defined(__AVX2__)
+
+inline int32_t horizontal_sum_i32(__m256i v) {
+    __m128i s = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0x4e));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0xb1));
+    return _mm_cvtsi128_si32(s);
+}
+
+// int8 values are sign-extended to int16 and multiplied by `pmaddwd`, which, unlike `pmaddubsw`, never saturates
+inline int32_t dot_i32(const int8_t* a, const int8_t* b, size_t n) {
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m256i va = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)));
+        const __m256i vb = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(va, vb));
+    }
+    return horizontal_sum_i32(acc) + dot_i32<int8_t, int8_t>(a + i, b + i, n - i);
+}
+
+inline int32_t dot_i32(const int16_t* a, const int16_t* b, size_t n) {
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(va, vb));
+    }
+    return horizontal_sum_i32(acc) + dot_i32<int16_t, int16_t>(a + i, b + i, n - i);
+}
+
+#endif
+
+/**
+ * @brief Computes dot product of `n` integers with `int64_t` accumulation, which doesn't overflow for any `n`
+ * of 8 and 16-bit values.
+ */
+template <typename T, typename U>
+int64_t dot_i64(const T* a, const U* b, size_t n) {
+    // products of 8-bit values are summed by blocks which can't overflow `int32_t`
+    const size_t block = sizeof(T) == 1 && sizeof(U) == 1 ? size_t(1) << 16 : 1;
+    int64_t sum = 0;
+    if (block > 1) {
+        for (size_t i = 0; i < n; i += block) {
+            sum += dot_i32(a + i, b + i, std::min(block, n - i));
+        }
+        return sum;
+    }
+    for (size_t i = 0; i < n; i++) {
+        sum += static_cast<int64_t>(a[i]) * static_cast<int64_t>(b[i]);
+    }
+    return sum;
+}
+
+#if defined(__AVX2__)
+
+// products of 16-bit values fit into `int32_t` and are widened before summation,
+// unlike sums of pairs by `pmaddwd`, which overflow for -32768 * -32768 * 2
+inline int64_t dot_i64(const int16_t* a, const int16_t* b, size_t n) {
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256i va = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)));
+        const __m256i vb = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+        const __m256i p = _mm256_mullo_epi32(va, vb);
+        acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(p)));
+        acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(p, 1)));
+    }
+    int64_t lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + dot_i64<int16_t, int16_t>(a + i, b + i, n - i);
+}
+
+#endif
+
+/**
+ * @brief Computes real product of matrix `a` quantized per row and matrix `b` quantized per column.
+ *
+ * Integer dot products are accumulated in `int64_t` (see `dot_i64`), so they don't overflow for any `a.cols()`.
+ *
+ * @param a first matrix
+ * @param b second matrix
+ * @param result matrix to store real product of a*b
+ */
+template <typename T, typename U, typename P>
+void quantized_product(const matrix<quantized_storage<T, quantization_axis::row>>& a,
+                       const matrix<quantized_storage<U, quantization_axis::col>>& b,
+                       P& result) {
+
+    lm_assert(a.cols() == b.rows(), a.cols() << " must be equal to " << b.rows() );
+
+    const size_t k = a.cols();
+
+    // columns of b are packed to make dot products contiguous
+    std::vector<U> bt(b.cols() * k);
+    std::vector<int64_t> b_sum(b.cols(), 0);
+    for (size_t j = 0; j < b.cols(); j++) {
+        for (size_t l = 0; l < k; l++) {
+            bt[j * k + l] = b(l, j);
+            b_sum[j] += b(l, j);
+        }
+    }
+
+    result.resize(a.rows(), b.cols());
+    for (size_t i = 0; i < a.rows(); i++) {
+        const T* ai = a.value().data() + i * k;
+        int64_t a_sum = 0;
+        for (size_t l = 0; l < k; l++) {
+            a_sum += ai[l];
+        }
+
+        const int64_t za = a.zero_point(i);
+        for (size_t j = 0; j < b.cols(); j++) {
+            const int64_t zb = b.zero_point(j);
+            const int64_t sum = dot_i64(ai, bt.data() + j * k, k)
+                - zb * a_sum - za * b_sum[j] + static_cast<int64_t>(k) * za * zb;
+            result(i, j) = static_cast<typename P::value_type>(
+                static_cast<double>(a.scale(i)) * b.scale(j) * static_cast<double>(sum));
+        }
+    }
+}
+
+}
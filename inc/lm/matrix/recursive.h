@@ -0,0 +1,278 @@
+/**
+ * @file
+ * @brief Recursive divide-and-conquer kernels running on work-stealing `task_pool`
+ *
+ * Kernels halve largest dimension of their problem until it fits into cache, so they don't depend on cache size
+ * (cache-oblivious), while halves of independent subproblems are forked as tasks. Unlike loops split
+ * into equal ranges by `parallel_for`, irregular work (e.g. triangular updates of LU-factorization)
+ * is balanced by stealing.
+ *
+ * With sequential policy or inside of parallel region (see `parallel_for`) kernels run on calling thread only.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+
+#include <lm/util/execution.h>
+#include <lm/util/perf_counters.h>
+#include <lm/util/stats.h>
+#include <lm/matrix/matrix.h>
+#include <lm/matrix/algorithm.h>
+
+namespace lm {
+
+/**
+ * @brief largest dimension of subproblem which isn't split further
+ */
+constexpr size_t recursive_leaf_size = 32;
+
+/**
+ * @brief runs `f1` and `f2` in parallel on pool of `policy` if `parallel` is set, sequentially otherwise
+ */
+template <typename F1, typename F2>
+void recursive_fork(const execution_policy& policy, bool parallel, F1&& f1, F2&& f2) {
+    if (parallel) {
+        policy.executor().fork_join(std::forward<F1>(f1), std::forward<F2>(f2));
+    } else {
+        f1();
+        f2();
+    }
+}
+
+/**
+ * @brief `true` if kernel which is called with `policy` may fork tasks
+ */
+inline bool recursive_parallel(const execution_policy& policy) {
+    return policy.parallel && policy.thread_count() > 1 && !in_parallel_region();
+}
+
+/**
+ * @brief Adds `Sign * m[i0:i1, k0:k1] * n[k0:k1, j0:j1]` to `result[i0:i1, j0:j1]`.
+ *
+ * Rows and columns of result are split in parallel, summation range is split sequentially,
+ * so each element accumulates its products in ascending order of `k`.
+ */
+template <int Sign, typename M, typename N, typename P>
+void product_recursive_block(const execution_policy& policy, bool parallel, const M& m, const N& n, P& result,
+                             size_t i0, size_t i1, size_t j0, size_t j1, size_t k0, size_t k1) {
+    typedef typename M::value_type acc_type;
+    typedef typename P::value_type value_type;
+
+    const size_t di = i1 - i0, dj = j1 - j0, dk = k1 - k0;
+    if (di <= recursive_leaf_size && dj <= recursive_leaf_size && dk <= recursive_leaf_size) {
+        if (is_col_major<P>::value) {
+            for (size_t j = j0; j < j1; j++) {
+                for (size_t k = k0; k < k1; k++) {
+                    const acc_type b = static_cast<acc_type>(n(k, j));
+                    for (size_t i = i0; i < i1; i++) {
+                        result(i, j) += static_cast<value_type>(Sign) * static_cast<value_type>(static_cast<acc_type>(m(i, k)) * b);
+                    }
+                }
+            }
+        } else {
+            for (size_t i = i0; i < i1; i++) {
+                for (size_t k = k0; k < k1; k++) {
+                    const acc_type a = static_cast<acc_type>(m(i, k));
+                    for (size_t j = j0; j < j1; j++) {
+                        result(i, j) += static_cast<value_type>(Sign) * static_cast<value_type>(a * static_cast<acc_type>(n(k, j)));
+                    }
+                }
+            }
+        }
+        return;
+    }
+
+    if (di >= dj && di >= dk) {
+        const size_t h = i0 + di / 2;
+        recursive_fork(policy, parallel,
+            [&]() { product_recursive_block<Sign>(policy, parallel, m, n, result, i0, h, j0, j1, k0, k1); },
+            [&]() { product_recursive_block<Sign>(policy, parallel, m, n, result, h, i1, j0, j1, k0, k1); });
+    } else if (dj >= dk) {
+        const size_t h = j0 + dj / 2;
+        recursive_fork(policy, parallel,
+            [&]() { product_recursive_block<Sign>(policy, parallel, m, n, result, i0, i1, j0, h, k0, k1); },
+            [&]() { product_recursive_block<Sign>(policy, parallel, m, n, result, i0, i1, h, j1, k0, k1); });
+    } else {
+        const size_t h = k0 + dk / 2;
+        product_recursive_block<Sign>(policy, parallel, m, n, result, i0, i1, j0, j1, k0, h);
+        product_recursive_block<Sign>(policy, parallel, m, n, result, i0, i1, j0, j1, h, k1);
+    }
+}
+
+/**
+ * @brief Computes product of matrix `m` and `n` by recursive halving and stores result in `result` matrix.
+ *
+ * Each element of result accumulates products in same order and types as by `product`, so results are equal.
+ *
+ * @param policy execution policy, parallel one forks halves of result on its pool
+ * @param m first matrix
+ * @param n second matrix
+ * @param result matrix to store product of m*n
+ */
+template <typename M, typename N, typename P = typename matrix_product<M, N>::value_matrix_type>
+void product_recursive(const execution_policy& policy, const M& m, const N& n, P& result) {
+
+    static_assert( M::Cols == 0 || N::Rows == 0 || M::Cols == N::Rows, "matricies can't be multiplied" );
+
+    lm_assert(m.cols() == n.rows(), m.cols() << " must be equal to " << n.rows() );
+
+    LM_PERF_SCOPE("product", m.rows(), n.cols());
+    LM_STATS_SCOPE(product, m.rows(), n.cols(), 2 * m.rows() * m.cols() * n.cols());
+
+    const bool parallel = recursive_parallel(policy);
+    result.resize(m.rows(), n.cols());
+    for (size_t i = 0; i < result.rows(); i++) {
+        for (size_t j = 0; j < result.cols(); j++) {
+            result(i, j) = 0;
+        }
+    }
+    if (m.rows() == 0 || n.cols() == 0 || m.cols() == 0) {
+        return;
+    }
+    product_recursive_block<1>(policy, parallel, m, n, result, 0, m.rows(), 0, n.cols(), 0, m.cols());
+}
+
+template <typename M, typename P>
+void transpose_recursive_block(const execution_policy& policy, bool parallel, const M& m, P& result,
+                               size_t i0, size_t i1, size_t j0, size_t j1) {
+    const size_t di = i1 - i0, dj = j1 - j0;
+    if (di <= recursive_leaf_size && dj <= recursive_leaf_size) {
+        // inner loop writes along rows or columns of result as they are stored
+        if (is_col_major<P>::value) {
+            for (size_t i = i0; i < i1; i++) {
+                for (size_t j = j0; j < j1; j++) {
+                    result(j, i) = m(i, j);
+                }
+            }
+        } else {
+            for (size_t j = j0; j < j1; j++) {
+                for (size_t i = i0; i < i1; i++) {
+                    result(j, i) = m(i, j);
+                }
+            }
+        }
+        return;
+    }
+    if (di >= dj) {
+        const size_t h = i0 + di / 2;
+        recursive_fork(policy, parallel,
+            [&]() { transpose_recursive_block(policy, parallel, m, result, i0, h, j0, j1); },
+            [&]() { transpose_recursive_block(policy, parallel, m, result, h, i1, j0, j1); });
+    } else {
+        const size_t h = j0 + dj / 2;
+        recursive_fork(policy, parallel,
+            [&]() { transpose_recursive_block(policy, parallel, m, result, i0, i1, j0, h); },
+            [&]() { transpose_recursive_block(policy, parallel, m, result, i0, i1, h, j1); });
+    }
+}
+
+/**
+ * @brief Stores transposed matrix `m` in `result` by cache-oblivious recursive halving.
+ *
+ * Blocks which are copied at once fit into cache for both layouts of source and result,
+ * so each cache line is loaded once regardless of cache size.
+ *
+ * @param policy execution policy, parallel one forks halves on its pool
+ * @param m matrix to transpose
+ * @param result transposed matrix
+ */
+template <typename M, typename P = typename matrix_transpose<M>::value_matrix_type>
+void transpose_recursive(const execution_policy& policy, const M& m, P& result) {
+    LM_PERF_SCOPE("transpose", m.rows(), m.cols());
+    LM_STATS_SCOPE(transpose, m.rows(), m.cols(), 0);
+    result.resize(m.cols(), m.rows());
+    if (m.rows() == 0 || m.cols() == 0) {
+        return;
+    }
+    transpose_recursive_block(policy, recursive_parallel(policy), m, result, 0, m.rows(), 0, m.cols());
+}
+
+/**
+ * @brief Solves @f$ L_{11} X = A_{12} @f$ in place for columns `[j0, j1)`, where @f$ L_{11} @f$ is unit lower
+ * triangular part of rows and columns `[c0, c1)` of `m`.
+ */
+template <typename M>
+void lu_recursive_solve_block(const execution_policy& policy, bool parallel, M& m,
+                              size_t c0, size_t c1, size_t j0, size_t j1) {
+    if (j1 - j0 > recursive_leaf_size) {
+        const size_t h = j0 + (j1 - j0) / 2;
+        recursive_fork(policy, parallel,
+            [&]() { lu_recursive_solve_block(policy, parallel, m, c0, c1, j0, h); },
+            [&]() { lu_recursive_solve_block(policy, parallel, m, c0, c1, h, j1); });
+        return;
+    }
+    for (size_t i = c0 + 1; i < c1; i++) {
+        for (size_t k = c0; k < i; k++) {
+            const typename M::value_type l = m(i, k);
+            for (size_t j = j0; j < j1; j++) {
+                m(i, j) -= l * m(k, j);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Factorizes columns `[c0, c1)` of rows `[c0, rows)`, previous columns must be already eliminated.
+ */
+template <typename M>
+bool lu_recursive_block(const execution_policy& policy, bool parallel, M& m, size_t c0, size_t c1,
+                        typename M::value_type tolerance) {
+    const size_t l = m.rows();
+    if (c1 - c0 <= 8) {
+        for (size_t i = c0; i < c1; i++) {
+            std::pair<size_t, bool> pivot = find_lu_pivot(m, i, tolerance);
+            if (!pivot.second) {
+                return false;
+            }
+            m.swap_row(pivot.first, i);
+            const typename M::value_type d = m(i, i);
+            for (size_t k = i + 1; k < l; k++) {
+                const typename M::value_type f = m(k, i) / d;
+                m(k, i) = f;
+                for (size_t j = i + 1; j < c1; j++) {
+                    m(k, j) -= f * m(i, j);
+                }
+            }
+        }
+        return true;
+    }
+
+    const size_t h = c0 + (c1 - c0) / 2;
+    if (!lu_recursive_block(policy, parallel, m, c0, h, tolerance)) {
+        return false;
+    }
+    // U12 = L11^-1 A12, A22 -= L21 U12
+    lu_recursive_solve_block(policy, parallel, m, c0, h, h, c1);
+    if (h < l) {
+        product_recursive_block<-1>(policy, parallel, m, m, m, h, l, h, c1, c0, h);
+    }
+    return lu_recursive_block(policy, parallel, m, h, c1, tolerance);
+}
+
+/**
+ * @brief Performs LU-factorization with row pivoting of matrix `m` by recursive halving of columns.
+ *
+ * Left half of columns is factorized, then right half is updated by triangular solve and product
+ * of recursive kernels and is factorized in turn. Result is stored same as by `lu_decomposition`
+ * and pivot rows are chosen by same rule, however since updates are grouped differently,
+ * elements may differ by rounding, which may also change choice between nearly equal pivots.
+ *
+ * @param policy execution policy, parallel one forks updates of trailing submatricies on its pool
+ * @param m matrix to perform LU-factorization
+ * @param tolerance pivots of at most this magnitude are treated as zero, exact zero by default (see `lu_pivot_tolerance`)
+ * @return `true` if LU-factorization succeds, `false` if matrix is singular and LU-factorization can't be performed
+ */
+template <typename M>
+bool lu_decomposition_recursive(const execution_policy& policy, M& m, const typename M::value_type tolerance = 0) {
+    LM_PERF_SCOPE("lu_decomposition", m.rows(), m.cols());
+    LM_STATS_SCOPE(lu_decomposition, m.rows(), m.cols(), 2 * m.rows() * m.rows() * m.rows() / 3);
+    if (m.rows() != m.cols()) {
+        throw std::invalid_argument("lu_decomposition_recursive(..) available only for square matricies");
+    }
+    return lu_recursive_block(policy, recursive_parallel(policy), m, 0, m.cols(), tolerance);
+}
+
+}
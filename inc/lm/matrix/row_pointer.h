@@ -0,0 +1,180 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <lm/util/assert.h>
+#include <lm/matrix/layout.h>
+#include <lm/matrix/matrix.h>
+
+namespace lm {
+
+/**
+ * @brief matrix storage which keeps rows in single container and addresses them by table of row offsets
+ *
+ * Each row is contiguous, but rows may be stored in any order, so `swap_row` and `permute_rows` only exchange
+ * row offsets instead of elements. `compact()` rewrites container in row order, after which elements are stored
+ * same as in row major `flat_dynamic_storage`.
+ *
+ * @tparam M container of elements, e.g. `std::vector<T>`
+ */
+template <typename M>
+class row_pointer_storage {
+public:
+    typedef typename std::remove_reference<M>::type::value_type value_type;
+    typedef row_major_layout layout_type;
+
+    constexpr static size_t Rows = 0;
+    constexpr static size_t Cols = 0;
+
+    typedef typename std::remove_reference<M>::type storage_type;
+    typedef matrix<row_pointer_storage<storage_type>> value_matrix_type;
+    typedef matrix<row_pointer_storage<storage_type&>> reference_matrix_type;
+
+    row_pointer_storage() : _c(0) {}
+
+    row_pointer_storage(const row_pointer_storage&) = default;
+    row_pointer_storage& operator=(const row_pointer_storage&) = default;
+
+    // move constructor, moved-from matrix becomes empty
+    row_pointer_storage(row_pointer_storage&& other) :
+        _m(std::forward<M>(other._m)), _rows(std::move(other._rows)), _c(other._c)
+    {
+        other._rows.clear();
+        other._c = 0;
+    }
+
+    row_pointer_storage& operator=(row_pointer_storage&& other) {
+        _m = std::forward<M>(other._m);
+        _rows = std::move(other._rows);
+        _c = other._c;
+        other._rows.clear();
+        other._c = 0;
+        return *this;
+    }
+
+    // initializer constructor
+    template <typename T>
+    row_pointer_storage(const std::initializer_list<std::initializer_list<T>>& m) : _c(0) {
+        static_cast<value_matrix_type*>(this)->assign(m);
+    }
+
+    // copy constructor
+    template <typename T>
+    row_pointer_storage(const T& other) : _c(0) {
+        static_cast<value_matrix_type*>(this)->assign(other);
+    }
+
+    row_pointer_storage(size_t r, size_t c) : _c(0) {
+        resize(r, c);
+    }
+
+    // reference constructor, container is addressed in row major order
+    template <typename T = M, typename = typename std::enable_if<std::is_reference<M>::value && std::is_same<T, M>::value>::type>
+    row_pointer_storage(M m, size_t r = 0, size_t c = 0) : _m(m), _c(0) {
+        resize(r, c);
+    }
+
+    size_t rows() const {
+        return _rows.size();
+    }
+
+    size_t cols() const {
+        return _c;
+    }
+
+    value_type& at(size_t row, size_t col) {
+        return _m[_rows[row] + col];
+    }
+
+    /**
+     * @brief pointer to first element of contiguous row
+     */
+    value_type* row_data(size_t row) {
+        return &_m[_rows[row]];
+    }
+
+    const value_type* row_data(size_t row) const {
+        return &_m[_rows[row]];
+    }
+
+    void swap_row(size_t r1, size_t r2) {
+        std::swap(_rows[r1], _rows[r2]);
+    }
+
+    void swap_col(size_t c1, size_t c2) {
+        lm::swap_col(*this, c1, c2);
+    }
+
+    /**
+     * @brief reorders rows so that row `i` becomes former row `p[i]`, elements aren't moved
+     */
+    template <typename P>
+    void permute_rows(const P& p) {
+        std::vector<size_t> permuted(rows());
+        for (size_t i = 0; i < permuted.size(); i++) {
+            lm_assert(p[i] < rows(), p[i] << " must be less than " << rows());
+            permuted[i] = _rows[p[i]];
+        }
+        _rows.swap(permuted);
+    }
+
+    /**
+     * @brief `true` if rows are stored in container in row order
+     */
+    bool is_compact() const {
+        for (size_t i = 0; i < _rows.size(); i++) {
+            if (_rows[i] != i * _c) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief rewrites container in row order, so subsequent sequential traversals read memory in order
+     */
+    void compact() {
+        if (is_compact()) {
+            return;
+        }
+        const storage_type copy(_m);
+        for (size_t i = 0; i < _rows.size(); i++) {
+            for (size_t j = 0; j < _c; j++) {
+                _m[i * _c + j] = copy[_rows[i] + j];
+            }
+            _rows[i] = i * _c;
+        }
+    }
+
+    // content of resized matrix is unspecified, like of `flat_dynamic_storage`
+    void resize(size_t rows, size_t cols) {
+        _m.resize(rows * cols);
+        _rows.resize(rows);
+        _c = cols;
+        for (size_t i = 0; i < rows; i++) {
+            _rows[i] = i * cols;
+        }
+    }
+
+    const storage_type& value() const { return _m; }
+    storage_type& value() { return _m; }
+
+private:
+    M _m;
+
+    // offset of first element of each row in `_m`
+    std::vector<size_t> _rows;
+    size_t _c;
+
+};
+
+template <typename M>
+using row_pointer_matrix = typename row_pointer_storage<M>::value_matrix_type;
+
+template <typename T>
+using vector_row_pointer_matrix = row_pointer_matrix<std::vector<T>>;
+
+}
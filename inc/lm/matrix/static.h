@@ -70,7 +70,7 @@ public:
     }
 
     void swap_col(size_t c1, size_t c2) {
-        lm::swap_row(*this, c1, c2);
+        lm::swap_col(*this, c1, c2);
     }
 
     value_type& at(size_t row, size_t col) {
@@ -94,6 +94,11 @@ private:
 
 };
 
+template <typename M, typename MT>
+struct matrix_layout<matrix<static_matrix_storage<M, MT>>, typename make_void<typename MT::layout_type>::type> {
+    typedef typename MT::layout_type type;
+};
+
 template <typename M, typename MT = matrix_traits<M>>
 using static_matrix = typename static_matrix_storage<M, MT>::value_matrix_type;
 
@@ -0,0 +1,590 @@
+/**
+ * @file
+ * @brief Reading and writing matricies in delimited text format (CSV, TSV, whitespace separated)
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <lm/util/half.h>
+#include <lm/matrix/matrix.h>
+
+namespace lm {
+
+/**
+ * @brief text format description
+ */
+struct text_format {
+
+    /**
+     * @brief value delimiter, `' '` means any amount of spaces and tabs
+     */
+    char delimiter;
+
+    /**
+     * @brief amount of leading lines to skip (i.e. CSV header)
+     */
+    size_t skip_lines;
+
+    text_format(char delimiter = ',', size_t skip_lines = 0) : delimiter(delimiter), skip_lines(skip_lines) {}
+
+    static text_format csv() { return text_format(','); }
+    static text_format tsv() { return text_format('\t'); }
+    static text_format whitespace() { return text_format(' '); }
+
+};
+
+/**
+ * @brief parses and formats numbers of type `T` without allocations
+ */
+template <typename T, typename Enable = void>
+struct text_number;
+
+template <typename T>
+struct text_number<T, typename std::enable_if<std::is_floating_point<T>::value>::type> {
+
+    constexpr static size_t max_length = 64;
+
+    /**
+     * @brief parses number from range [`p`, `end`)
+     * @return pointer past the last parsed character, `nullptr` if range doesn't start with a number
+     */
+    static const char* parse(const char* p, const char* end, T& value) {
+        const char* start = p;
+
+        const bool negative = p != end && *p == '-';
+        if (p != end && (*p == '-' || *p == '+')) {
+            ++p;
+        }
+
+        uint64_t mantissa = 0;
+        int exp10 = 0;
+        int digits = 0;
+        bool any = false, exact = true;
+        for (; p != end && is_digit(*p); ++p, any = true) {
+            accumulate(*p, mantissa, digits, exp10, exact);
+        }
+        if (p != end && *p == '.') {
+            for (++p; p != end && is_digit(*p); ++p, any = true) {
+                accumulate(*p, mantissa, digits, exp10, exact);
+                --exp10;
+            }
+        }
+        if (!any) {
+            return parse_slow(start, end, value);
+        }
+        if (p != end && (*p == 'e' || *p == 'E')) {
+            const char* e = p + 1;
+            const bool negative_exp = e != end && *e == '-';
+            if (e != end && (*e == '-' || *e == '+')) {
+                ++e;
+            }
+            if (e == end || !is_digit(*e)) {
+                return parse_slow(start, end, value);
+            }
+            int exp = 0;
+            for (; e != end && is_digit(*e); ++e) {
+                exp = exp < 10000 ? exp * 10 + (*e - '0') : exp;
+            }
+            exp10 += negative_exp ? -exp : exp;
+            p = e;
+        }
+
+        // exact conversion is possible only if mantissa and power of 10 both are exactly representable
+        if (!exact || mantissa > max_exact_mantissa() || exp10 < -max_exact_exp10() || exp10 > max_exact_exp10()) {
+            return parse_slow(start, end, value);
+        }
+        T v = static_cast<T>(mantissa);
+        v = exp10 < 0 ? v / pow10(-exp10) : v * pow10(exp10);
+        value = negative ? -v : v;
+        return p;
+    }
+
+    /**
+     * @brief formats `value` into `buf` using shortest representation which can be parsed back without loss
+     * @return amount of written characters
+     */
+    static size_t format(char* buf, T value) {
+        int n = print(buf, std::numeric_limits<T>::digits10, value);
+        T parsed;
+        if (parse(buf, buf + n, parsed) == nullptr || parsed != value) {
+            n = print(buf, std::numeric_limits<T>::max_digits10, value);
+        }
+        return static_cast<size_t>(n);
+    }
+
+private:
+
+    static bool is_digit(char c) {
+        return c >= '0' && c <= '9';
+    }
+
+    static void accumulate(char c, uint64_t& mantissa, int& digits, int& exp10, bool& exact) {
+        if (digits < 19) {
+            mantissa = mantissa * 10 + static_cast<uint64_t>(c - '0');
+            digits += mantissa != 0 ? 1 : 0;
+        } else {
+            ++exp10;
+            exact = exact && c == '0';
+        }
+    }
+
+    // every mantissa of at most 19 digits is exact if type has 64 bits of mantissa or more (e.g. `long double`)
+    constexpr static uint64_t max_exact_mantissa() {
+        return std::numeric_limits<T>::digits >= 64 ? std::numeric_limits<uint64_t>::max()
+            : uint64_t(1) << (std::numeric_limits<T>::digits < 64 ? std::numeric_limits<T>::digits : 0);
+    }
+
+    constexpr static int max_exact_exp10() {
+        return std::numeric_limits<T>::digits <= 24 ? 10 : 22;
+    }
+
+    static T pow10(int e) {
+        static const T table[] = {
+            T(1e0), T(1e1), T(1e2), T(1e3), T(1e4), T(1e5), T(1e6), T(1e7), T(1e8), T(1e9), T(1e10), T(1e11),
+            T(1e12), T(1e13), T(1e14), T(1e15), T(1e16), T(1e17), T(1e18), T(1e19), T(1e20), T(1e21), T(1e22)
+        };
+        return table[e];
+    }
+
+    static const char* parse_slow(const char* p, const char* end, T& value) {
+        char buf[max_length + 1];
+        size_t n = 0;
+        while (p + n != end && n < max_length && p[n] != ',' && p[n] != ';' &&
+               p[n] != ' ' && p[n] != '\t' && p[n] != '\n' && p[n] != '\r') {
+            buf[n] = p[n];
+            ++n;
+        }
+        buf[n] = 0;
+
+        char* e = buf;
+        value = convert(buf, &e, static_cast<T*>(nullptr));
+        return e == buf ? nullptr : p + (e - buf);
+    }
+
+    static float convert(const char* s, char** e, float*) { return std::strtof(s, e); }
+    static double convert(const char* s, char** e, double*) { return std::strtod(s, e); }
+    static long double convert(const char* s, char** e, long double*) { return std::strtold(s, e); }
+
+    static int print(char* buf, int precision, double v) {
+        return std::snprintf(buf, max_length, "%.*g", precision, v);
+    }
+
+    static int print(char* buf, int precision, long double v) {
+        return std::snprintf(buf, max_length, "%.*Lg", precision, v);
+    }
+
+};
+
+template <typename T>
+struct text_number<T, typename std::enable_if<std::is_integral<T>::value>::type> {
+
+    constexpr static size_t max_length = 24;
+
+    static const char* parse(const char* p, const char* end, T& value) {
+        const bool negative = p != end && *p == '-';
+        if (p != end && (*p == '-' || *p == '+')) {
+            ++p;
+        }
+        if (p == end || *p < '0' || *p > '9' || (negative && !std::is_signed<T>::value)) {
+            return nullptr;
+        }
+
+        const uint64_t limit = negative
+            ? static_cast<uint64_t>(-(std::numeric_limits<T>::min() + 1)) + 1
+            : static_cast<uint64_t>(std::numeric_limits<T>::max());
+
+        uint64_t v = 0;
+        for (; p != end && *p >= '0' && *p <= '9'; ++p) {
+            const uint64_t d = static_cast<uint64_t>(*p - '0');
+            if (v > (limit - d) / 10) {
+                throw std::out_of_range("integer value is out of range");
+            }
+            v = v * 10 + d;
+        }
+        value = negative ? static_cast<T>(-static_cast<int64_t>(v - 1) - 1) : static_cast<T>(v);
+        return p;
+    }
+
+    static size_t format(char* buf, T value) {
+        char tmp[max_length];
+        size_t n = 0;
+        uint64_t v = value < 0 ? static_cast<uint64_t>(-(static_cast<int64_t>(value) + 1)) + 1 : static_cast<uint64_t>(value);
+        do {
+            tmp[n++] = static_cast<char>('0' + v % 10);
+            v /= 10;
+        } while (v != 0);
+
+        size_t len = 0;
+        if (value < 0) {
+            buf[len++] = '-';
+        }
+        while (n > 0) {
+            buf[len++] = tmp[--n];
+        }
+        return len;
+    }
+
+};
+
+// compact floating point numbers are parsed and formatted as float
+template <typename F>
+struct text_number<compact_float<F>> {
+
+    constexpr static size_t max_length = text_number<float>::max_length;
+
+    static const char* parse(const char* p, const char* end, compact_float<F>& value) {
+        float f;
+        const char* e = text_number<float>::parse(p, end, f);
+        if (e != nullptr) {
+            value = f;
+        }
+        return e;
+    }
+
+    static size_t format(char* buf, compact_float<F> value) {
+        return text_number<float>::format(buf, value);
+    }
+
+};
+
+/**
+ * @brief streaming tokenizer of delimited text
+ *
+ * Reads input by fixed-size chunks, so no per-line allocations are made.
+ * Can also operate directly on in-memory buffer without copying it.
+ */
+class text_parser {
+public:
+
+    constexpr static size_t chunk_size = 1 << 16;
+    constexpr static size_t lookahead = 128;
+
+    text_parser(std::istream& in, const text_format& format) :
+        _in(&in), _format(format), _buf(chunk_size + lookahead), _p(_buf.data()), _end(_buf.data()), _line(1)
+    {
+        refill();
+    }
+
+    text_parser(const char* data, size_t size, const text_format& format) :
+        _in(nullptr), _format(format), _p(data), _end(data + size), _line(1)
+    {
+    }
+
+    /**
+     * @brief reads all rows and appends values to `out`
+     * @param out values in row major order
+     * @return pair of row and column count
+     */
+    template <typename T, typename V>
+    std::pair<size_t, size_t> read(V& out) {
+        for (size_t i = 0; i < _format.skip_lines && !eof(); i++) {
+            skip_line();
+        }
+
+        size_t rows = 0, cols = 0;
+        while (skip_empty_lines()) {
+            size_t c = 0;
+            while (true) {
+                skip_spaces();
+                ensure(text_number<T>::max_length + lookahead);
+
+                T value;
+                const char* next;
+                try {
+                    next = text_number<T>::parse(_p, _end, value);
+                } catch (const std::out_of_range& e) {
+                    throw std::out_of_range(std::string(e.what()) + " at line " + std::to_string(_line));
+                }
+                if (next == nullptr) {
+                    error("number expected");
+                }
+                _p = next;
+                out.push_back(value);
+                ++c;
+
+                skip_spaces();
+                if (eof() || *_p == '\n' || *_p == '\r') {
+                    break;
+                }
+                if (_format.delimiter != ' ') {
+                    if (*_p != _format.delimiter) {
+                        error("delimiter expected");
+                    }
+                    ++_p;
+                }
+            }
+            if (rows != 0 && c != cols) {
+                error("row length mismatch");
+            }
+            cols = c;
+            ++rows;
+        }
+        return std::make_pair(rows, cols);
+    }
+
+private:
+
+    bool eof() {
+        return _p == _end && !refill();
+    }
+
+    void ensure(size_t n) {
+        if (static_cast<size_t>(_end - _p) < n) {
+            refill();
+        }
+    }
+
+    bool refill() {
+        if (_in == nullptr || !*_in) {
+            return false;
+        }
+        const size_t tail = static_cast<size_t>(_end - _p);
+        std::memmove(_buf.data(), _p, tail);
+        _in->read(_buf.data() + tail, static_cast<std::streamsize>(_buf.size() - tail));
+        _p = _buf.data();
+        _end = _buf.data() + tail + static_cast<size_t>(_in->gcount());
+        return _end != _buf.data() + tail;
+    }
+
+    void skip_spaces() {
+        while (!eof() && (*_p == ' ' || *_p == '\t') && (*_p != _format.delimiter || _format.delimiter == ' ')) {
+            ++_p;
+        }
+    }
+
+    void skip_line() {
+        while (!eof() && *_p != '\n') {
+            ++_p;
+        }
+        if (!eof()) {
+            ++_p;
+            ++_line;
+        }
+    }
+
+    bool skip_empty_lines() {
+        while (!eof()) {
+            if (*_p == '\n') {
+                ++_line;
+            } else if (*_p != '\r' && *_p != ' ' && *_p != '\t') {
+                return true;
+            }
+            ++_p;
+        }
+        return false;
+    }
+
+    void error(const char* what) {
+        throw std::runtime_error(std::string(what) + " at line " + std::to_string(_line));
+    }
+
+    std::istream* _in;
+    text_format _format;
+    std::vector<char> _buf;
+    const char* _p;
+    const char* _end;
+    size_t _line;
+
+};
+
+/**
+ * @brief buffered writer of delimited text
+ */
+class text_writer {
+public:
+
+    constexpr static size_t buffer_size = 1 << 16;
+
+    text_writer(std::ostream& out, const text_format& format) : _out(out), _format(format), _n(0) {}
+
+    ~text_writer() {
+        flush();
+    }
+
+    template <typename M>
+    void write(const M& m) {
+        typedef typename M::value_type value_type;
+        for (size_t i = 0; i < m.rows(); i++) {
+            for (size_t j = 0; j < m.cols(); j++) {
+                reserve(text_number<value_type>::max_length + 1);
+                if (j != 0) {
+                    _buf[_n++] = _format.delimiter;
+                }
+                _n += text_number<value_type>::format(_buf + _n, m(i, j));
+            }
+            reserve(1);
+            _buf[_n++] = '\n';
+        }
+    }
+
+    void flush() {
+        _out.write(_buf, static_cast<std::streamsize>(_n));
+        _n = 0;
+    }
+
+private:
+
+    void reserve(size_t n) {
+        if (_n + n > buffer_size) {
+            flush();
+        }
+    }
+
+    std::ostream& _out;
+    text_format _format;
+    char _buf[buffer_size];
+    size_t _n;
+
+};
+
+/**
+ * @brief collects parsed values and stores them into matrix `M`
+ */
+template <typename M>
+struct text_target {
+
+    typedef typename M::value_type value_type;
+
+    explicit text_target(M& m) : _m(m) {}
+
+    std::vector<value_type>& values() {
+        return _values;
+    }
+
+    void finish(size_t rows, size_t cols) {
+        _m.resize(rows, cols);
+        for (size_t i = 0; i < rows; i++) {
+            for (size_t j = 0; j < cols; j++) {
+                _m(i, j) = _values[i * cols + j];
+            }
+        }
+    }
+
+private:
+    M& _m;
+    std::vector<value_type> _values;
+};
+
+// row major vector matrix takes over container of parsed values, matrix is left unchanged if parsing fails
+template <typename T, typename A>
+struct text_target<matrix<flat_dynamic_storage<std::vector<T, A>, row_major_layout>>> {
+
+    typedef matrix<flat_dynamic_storage<std::vector<T, A>, row_major_layout>> matrix_type;
+
+    explicit text_target(matrix_type& m) : _m(m), _values(m.value().get_allocator()) {}
+
+    std::vector<T, A>& values() {
+        return _values;
+    }
+
+    void finish(size_t rows, size_t cols) {
+        _m.value().swap(_values);
+        _m.resize(rows, cols);
+    }
+
+private:
+    matrix_type& _m;
+    std::vector<T, A> _values;
+};
+
+/**
+ * @brief Reads delimited text from stream `in` into matrix `m`.
+ *
+ * Each non-empty line is a matrix row, all rows must have the same amount of values.
+ * Matrix `m` is resized to the amount of read rows and columns, if text is malformed `m` is left unchanged.
+ *
+ * @param in input stream
+ * @param m matrix to read
+ * @param format text format
+ * @throws std::runtime_error if text is malformed
+ */
+template <typename M>
+void read_text(std::istream& in, M& m, const text_format& format = text_format()) {
+    text_target<M> target(m);
+    const std::pair<size_t, size_t> size = text_parser(in, format).read<typename M::value_type>(target.values());
+    target.finish(size.first, size.second);
+}
+
+/**
+ * @brief Reads delimited text from memory buffer into matrix `m`.
+ *
+ * @param data pointer to text, not required to be null-terminated
+ * @param size text length
+ * @param m matrix to read
+ * @param format text format
+ * @throws std::runtime_error if text is malformed
+ */
+template <typename M>
+void read_text(const char* data, size_t size, M& m, const text_format& format = text_format()) {
+    text_target<M> target(m);
+    const std::pair<size_t, size_t> sz = text_parser(data, size, format).read<typename M::value_type>(target.values());
+    target.finish(sz.first, sz.second);
+}
+
+/**
+ * @brief Writes matrix `m` to stream `out` as delimited text, one row per line.
+ *
+ * Floating point values are written with the shortest precision which allows to read them back without loss.
+ *
+ * @param out output stream
+ * @param m matrix to write
+ * @param format text format
+ * @throw std::runtime_error if matrix can't be written, e.g. disk is full
+ */
+template <typename M>
+void write_text(std::ostream& out, const M& m, const text_format& format = text_format()) {
+    text_writer writer(out, format);
+    writer.write(m);
+    writer.flush();
+    out.flush();
+    if (!out) {
+        throw std::runtime_error("can't write matrix");
+    }
+}
+
+/**
+ * @brief Reads matrix `m` from delimited text file `path`.
+ */
+template <typename M>
+void load_text(const std::string& path, M& m, const text_format& format = text_format()) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("can't open " + path + " for reading");
+    }
+    read_text(in, m, format);
+}
+
+/**
+ * @brief Writes matrix `m` to delimited text file `path`.
+ */
+template <typename M>
+void save_text(const std::string& path, const M& m, const text_format& format = text_format()) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("can't open " + path + " for writing");
+    }
+    write_text(out, m, format);
+}
+
+template <typename S>
+std::ostream& operator<<(std::ostream& out, const matrix<S>& m) {
+    // errors are reported by state of stream as by other output operators
+    text_writer(out, text_format::whitespace()).write(m);
+    return out;
+}
+
+}
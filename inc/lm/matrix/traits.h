@@ -39,6 +39,7 @@ struct matrix_traits<T, typename std::enable_if<
 
     typedef typename std::remove_reference<T>::type container_type;
     typedef typename std::remove_all_extents< container_type >::type value_type;
+    typedef row_major_layout layout_type;
 
     constexpr static size_t Rows = std::extent<container_type, 0>::value;
     constexpr static size_t Cols = std::extent<container_type, 1>::value;
@@ -119,6 +120,7 @@ struct flat_matrix_traits {
 
     typedef T container_type;
     typedef V value_type;
+    typedef L layout_type;
 
     constexpr static size_t Rows = R;
     constexpr static size_t Cols = C;
@@ -1,8 +1,11 @@
 #pragma once
 
 #include <type_traits>
+#include <utility>
 
 #include <lm/matrix/decorator.h>
+#include <lm/matrix/flat.h>
+#include <lm/matrix/layout.h>
 
 namespace lm {
 
@@ -13,20 +16,31 @@ public:
     typedef typename base_type::value_type value_type;
     typedef typename base_type::storage_type storage_type;
 
+    // elements of view of const matrix are read-only
+    typedef typename std::conditional<std::is_const<storage_type>::value,
+        const value_type&, value_type&>::type reference;
+
     transpose_storage() = default;
 
     template <typename T> transpose_storage(const std::initializer_list<T>& other) : _m(other) {}
     template <typename T> transpose_storage(const std::initializer_list<std::initializer_list<T>>& other) : _m(other) {}
     template <typename T> transpose_storage(const T& other) : _m(other) {}
 
+    // takes over underlying matrix
+    template <typename T = M, typename = typename std::enable_if<!std::is_reference<T>::value && std::is_same<T, M>::value>::type>
+    transpose_storage(storage_type&& other) : _m(std::move(other)) {}
+
+    // copies underlying matrix of another transposed matrix
+    template <typename T> transpose_storage(const matrix<transpose_storage<T>>& other) : _m(other.value()) {}
+
     template <typename T = M, typename = typename std::enable_if<std::is_reference<T>::value && std::is_same<T, M>::value>::type>
     transpose_storage(M ref) : _m(ref) {}
 
     size_t rows() const { return _m.cols(); }
     size_t cols() const { return _m.rows(); }
 
-    value_type& at(size_t row, size_t col) {
-        return _m.at(col, row);
+    reference at(size_t row, size_t col) {
+        return _m(col, row);
     }
 
     void resize(size_t rows, size_t cols) {
@@ -49,7 +63,86 @@ private:
 
 };
 
-template <typename M> using transpose_matrix = typename transpose_storage<M>::value_matrix_type;
+// value of transposed twice matrix is the value of matrix itself
+template <typename M>
+struct decorated_matrix<transpose_storage, matrix<transpose_storage<M>>> {
+    typedef typename matrix_decorator<transpose_storage, M>::value_storage_type::value_matrix_type type;
+};
+
+// value of transposed flat matrix is flat matrix with same elements in flipped layout, elements aren't moved
+template <typename C, typename L>
+struct decorated_matrix<transpose_storage, matrix<flat_dynamic_storage<C, L>>> {
+    typedef matrix<flat_dynamic_storage<C, typename flipped_layout<L>::type>> type;
+};
+
+// transposed flat matrix is flat matrix with flipped layout
+template <typename M>
+struct flat_traits<matrix<transpose_storage<M>>,
+        typename std::enable_if<flat_traits<typename matrix_decorator<transpose_storage, M>::value_storage_type>::is_flat>::type> {
+
+    typedef flat_traits<typename matrix_decorator<transpose_storage, M>::value_storage_type> storage_traits;
+
+    constexpr static bool is_flat = true;
+    typedef typename flipped_layout<typename storage_traits::layout_type>::type layout_type;
+
+    template <typename T>
+    static auto data(T& m) -> decltype(storage_traits::data(m.value())) {
+        return storage_traits::data(m.value());
+    }
+};
+
+template <typename M>
+struct matrix_layout<matrix<transpose_storage<M>>> {
+    typedef typename flipped_layout<typename matrix_layout<
+        typename matrix_decorator<transpose_storage, M>::value_storage_type>::type>::type type;
+};
+
+/**
+ * @brief matrix which stores matrix `M` and exposes it transposed
+ *
+ * Type itself is never collapsed, `transpose_matrix<M>(m)` transposes `m` for any `M`, including already
+ * transposed one, while its `value_matrix_type` is collapsed: value of transposed twice matrix is the value type
+ * of matrix itself and value of transposed flat dynamic matrix is flat matrix with flipped layout.
+ */
+template <typename M> using transpose_matrix = matrix<transpose_storage<M>>;
+
+/**
+ * @brief Transposed view of matrix `m`, no elements are copied and modifications of view are applied to `m`.
+ *
+ * Products with views are computed directly on storage of `m` in loop order chosen by flipped layout,
+ * so for example @f$ A^T B @f$ is computed without transposing `A`:
+ *
+ * @code
+ * product(transposed(a), b, p);
+ * @endcode
+ *
+ * @param m matrix to view
+ */
+template <typename M>
+matrix<transpose_storage<M&>> transposed(M& m) {
+    return matrix<transpose_storage<M&>>(m);
+}
+
+/**
+ * @brief Transposed view of transposed view is the matrix which the view refers to.
+ */
+template <typename M>
+M& transposed(matrix<transpose_storage<M&>>& m) {
+    return m.value();
+}
+
+template <typename M>
+M& transposed(matrix<transpose_storage<M&>>&& m) {
+    return m.value();
+}
+
+/**
+ * @brief Read-only transposed view of matrix `m`, elements of view can't be modified.
+ */
+template <typename M>
+matrix<transpose_storage<const M&>> transposed(const M& m) {
+    return matrix<transpose_storage<const M&>>(m);
+}
 
 
 }
@@ -1,14 +1,45 @@
 #pragma once
 
 #include <cstddef>
+#include <type_traits>
+#include <vector>
 
+#include <lm/util/arena.h>
+#include <lm/matrix/fwd.h>
+#include <lm/matrix/layout.h>
 #include <lm/matrix/traits.h>
 
 namespace lm {
 
+template <typename...>
+struct make_void {
+    typedef void type;
+};
+
+/**
+ * @brief layout in which elements of matrix `M` are stored in memory, matricies without layout are treated as row major
+ *
+ * Decorators specialize it, e.g. layout of transposed matrix is flipped layout of underlying matrix.
+ */
+template <typename M, typename Enable = void>
+struct matrix_layout {
+    typedef row_major_layout type;
+};
+
+template <typename M>
+struct matrix_layout<M, typename make_void<typename M::layout_type>::type> {
+    typedef typename M::layout_type type;
+};
+
+/**
+ * @brief `true` if elements of same column of matrix `M` are adjacent in memory
+ */
+template <typename M>
+struct is_col_major: public std::is_same<typename matrix_layout<M>::type, col_major_layout> {};
+
 template <typename M, size_t R, size_t C, typename Enable = void>
 struct matrix_with_size {
-    typedef M value_matrix_type;
+    typedef typename M::value_matrix_type value_matrix_type;
 };
 
 template <typename M, size_t R, size_t C>
@@ -26,10 +57,27 @@ struct matrix_product {
     typedef typename std::conditional<M::Rows != 0, // M is static?
         typename std::conditional<N::Cols != 0, // N is static?
             typename matrix_with_size<M, M::Rows, N::Cols>::value_matrix_type, // both is static
-            N // N is dynamic
+            typename N::value_matrix_type // N is dynamic
         >::type,
-        M // M is dynamic
+        typename M::value_matrix_type // M is dynamic
     >::type value_matrix_type;
 };
 
+/**
+ * @brief type of temporary matrix for computations with matrix `M`
+ *
+ * Static matricies are used as is, dynamic matricies are replaced by row major matricies
+ * which take memory from current arena (see `arena_scope`).
+ */
+template <typename M, typename Enable = void>
+struct matrix_workspace {
+    typedef typename M::value_type value_type;
+    typedef matrix<flat_dynamic_storage<std::vector<value_type, arena_allocator<value_type>>, row_major_layout>> value_matrix_type;
+};
+
+template <typename M>
+struct matrix_workspace<M, typename std::enable_if<M::Rows != 0 && M::Cols != 0>::type> {
+    typedef typename M::value_matrix_type value_matrix_type;
+};
+
 }
@@ -0,0 +1,97 @@
+/**
+ * @file
+ * @brief Product of matricies with compact element types
+ *
+ * Matricies of `half` or `bfloat16` elements take half of memory and bandwidth of `float` matricies,
+ * but must be converted to wider type for arithmetic. Product below converts operands by tiles
+ * right before they're used, so only tiles (not whole matricies) exist in wide type.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include <lm/util/assert.h>
+#include <lm/util/half.h>
+#include <lm/matrix/flat.h>
+
+namespace lm {
+
+/**
+ * @brief converts `count` elements of row `row` of matrix `m` starting at column `first` to type `W`
+ *
+ * Elements of row major flat matricies are converted by bulk conversion (see `convert_elements`).
+ */
+template <typename M, typename W>
+void widen_row(const M& m, size_t row, size_t first, size_t count, W* dst) {
+    const typename M::value_type* data = row_major_data(const_cast<M&>(m));
+    if (data != nullptr) {
+        convert_elements(data + row * m.cols() + first, dst, count);
+        return;
+    }
+    for (size_t j = 0; j < count; j++) {
+        dst[j] = static_cast<W>(m(row, first + j));
+    }
+}
+
+/**
+ * @brief Computes product of matrix `m` and `n` converting elements to type `W` by tiles.
+ *
+ * Right operand is converted by tiles of @f$ Tile \times Tile @f$ elements, left operand - by row segments of `Tile` elements.
+ * Sums are accumulated in type `W` by tiles of @f$ Tile \times Tile @f$ elements of result and converted
+ * to `P::value_type` once when stored, so temporary memory doesn't depend on size of matricies.
+ * Tiles of right operand are converted once per tile of result.
+ *
+ * @tparam W type of converted elements and accumulator
+ * @tparam Tile tile size
+ * @param m first matrix
+ * @param n second matrix
+ * @param result matrix to store product of m*n
+ */
+template <typename W = float, size_t Tile = 64, typename M, typename N, typename P>
+void widening_product(const M& m, const N& n, P& result) {
+
+    static_assert( M::Cols == 0 || N::Rows == 0 || M::Cols == N::Rows, "matricies can't be multiplied" );
+
+    lm_assert(m.cols() == n.rows(), m.cols() << " must be equal to " << n.rows() );
+
+    result.resize(m.rows(), n.cols());
+
+    std::vector<W> a(Tile), b(Tile * Tile), acc(Tile * Tile);
+    for (size_t j0 = 0; j0 < n.cols(); j0 += Tile) {
+        const size_t jn = std::min(Tile, n.cols() - j0);
+        for (size_t i0 = 0; i0 < m.rows(); i0 += Tile) {
+            const size_t in = std::min(Tile, m.rows() - i0);
+            std::fill(acc.begin(), acc.end(), W());
+
+            for (size_t k0 = 0; k0 < n.rows(); k0 += Tile) {
+                const size_t kn = std::min(Tile, n.rows() - k0);
+                for (size_t k = 0; k < kn; k++) {
+                    widen_row(n, k0 + k, j0, jn, &b[k * Tile]);
+                }
+
+                for (size_t i = 0; i < in; i++) {
+                    widen_row(m, i0 + i, k0, kn, a.data());
+                    W* c = &acc[i * Tile];
+                    for (size_t k = 0; k < kn; k++) {
+                        const W v = a[k];
+                        const W* bk = &b[k * Tile];
+                        for (size_t j = 0; j < jn; j++) {
+                            c[j] += v * bk[j];
+                        }
+                    }
+                }
+            }
+
+            for (size_t i = 0; i < in; i++) {
+                for (size_t j = 0; j < jn; j++) {
+                    result(i0 + i, j0 + j) = static_cast<typename P::value_type>(acc[i * Tile + j]);
+                }
+            }
+        }
+    }
+}
+
+}
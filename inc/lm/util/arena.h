@@ -0,0 +1,169 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include <lm/util/stats.h>
+
+namespace lm {
+
+/**
+ * @brief bump allocator for temporary matricies
+ *
+ * Memory is taken from large blocks and is never released individually.
+ * `reset()` makes all blocks available again without returning them to the system,
+ * so after first iteration of a loop which resets arena no more heap allocations are performed.
+ */
+class arena {
+public:
+
+    explicit arena(size_t block_size = 64 * 1024) : _block_size(block_size), _current(0), _offset(0) {}
+
+    arena(const arena&) = delete;
+    arena& operator=(const arena&) = delete;
+
+    void* allocate(size_t size, size_t alignment) {
+        for (; _current < _blocks.size(); ++_current, _offset = 0) {
+            void* p = allocate_from(_blocks[_current], size, alignment);
+            if (p != nullptr) {
+                return p;
+            }
+        }
+        _blocks.push_back(block(std::max(_block_size, size + alignment)));
+        _current = _blocks.size() - 1;
+        _offset = 0;
+        return allocate_from(_blocks.back(), size, alignment);
+    }
+
+    /**
+     * @brief makes all memory available for reuse, all previously allocated memory becomes invalid
+     */
+    void reset() {
+        _current = 0;
+        _offset = 0;
+    }
+
+    /**
+     * @brief returns all blocks to the system
+     */
+    void release() {
+        _blocks.clear();
+        reset();
+    }
+
+    /**
+     * @brief total size of allocated blocks
+     */
+    size_t capacity() const {
+        size_t c = 0;
+        for (const block& b : _blocks) {
+            c += b.size;
+        }
+        return c;
+    }
+
+private:
+
+    struct block {
+        explicit block(size_t size) : data(new char[size]), size(size) {}
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    void* allocate_from(block& b, size_t size, size_t alignment) {
+        const uintptr_t base = reinterpret_cast<uintptr_t>(b.data.get());
+        const uintptr_t p = (base + _offset + alignment - 1) / alignment * alignment;
+        if (p + size > base + b.size) {
+            return nullptr;
+        }
+        _offset = static_cast<size_t>(p + size - base);
+        return reinterpret_cast<void*>(p);
+    }
+
+    size_t _block_size;
+    std::vector<block> _blocks;
+    size_t _current;
+    size_t _offset;
+
+};
+
+/**
+ * @brief arena used by current thread for temporary matricies, `nullptr` if heap is used
+ */
+inline arena*& current_arena() {
+    thread_local arena* a = nullptr;
+    return a;
+}
+
+/**
+ * @brief makes arena `a` current for this thread until end of scope
+ */
+class arena_scope {
+public:
+    explicit arena_scope(arena& a) : _prev(current_arena()) {
+        current_arena() = &a;
+    }
+
+    arena_scope(const arena_scope&) = delete;
+    arena_scope& operator=(const arena_scope&) = delete;
+
+    ~arena_scope() {
+        current_arena() = _prev;
+    }
+
+private:
+    arena* _prev;
+};
+
+/**
+ * @brief allocator which takes memory from arena which was current at the moment of allocator construction
+ *
+ * If there was no current arena memory is taken from heap.
+ */
+template <typename T>
+class arena_allocator {
+public:
+    typedef T value_type;
+
+    arena_allocator() : _arena(current_arena()) {}
+    explicit arena_allocator(arena* a) : _arena(a) {}
+
+    template <typename U>
+    arena_allocator(const arena_allocator<U>& other) : _arena(other.get_arena()) {}
+
+    T* allocate(size_t n) {
+        LM_STATS_ALLOCATE(n * sizeof(T));
+        return static_cast<T*>(_arena != nullptr
+            ? _arena->allocate(n * sizeof(T), alignof(T))
+            : ::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t) {
+        if (_arena == nullptr) {
+            ::operator delete(p);
+        }
+    }
+
+    arena* get_arena() const {
+        return _arena;
+    }
+
+private:
+    arena* _arena;
+};
+
+template <typename T, typename U>
+bool operator==(const arena_allocator<T>& a, const arena_allocator<U>& b) {
+    return a.get_arena() == b.get_arena();
+}
+
+template <typename T, typename U>
+bool operator!=(const arena_allocator<T>& a, const arena_allocator<U>& b) {
+    return !(a == b);
+}
+
+}
@@ -0,0 +1,154 @@
+/**
+ * @file
+ * @brief Execution policies of algorithms
+ *
+ * Heavy algorithms accept `execution_policy` as first argument in the spirit of C++17 `std::execution` policies,
+ * so decision whether to run in parallel may be moved from call sites to configuration:
+ *
+ * @code
+ * const execution_policy policy = batch_worker ? execution::par.with_threads(8) : execution::seq;
+ * product(policy, a, b, p);
+ * @endcode
+ *
+ * Parallel policies split outermost independent loop of algorithm into ranges of at least `grain` iterations
+ * (rows or columns of result) which are run on up to `threads` threads of `task_pool`. Each element receives
+ * same sequence of operations as in sequential run, so results don't depend on policy.
+ *
+ * Reductions which take policy (`sum`, `scalar_product` of matricies and vectors, `length_square`) add terms
+ * by fixed pairwise tree of `reproducible_sum`, so they are bit-identical across runs, policies and thread counts
+ * as well. Overloads of vector ones without policy keep running sum.
+ *
+ * Innermost loops of kernels are unit-stride for any policy and left to compiler auto-vectorization,
+ * so `simd` runs as `seq` and `par_simd` as `par`. They are accepted to keep call sites portable.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <thread>
+
+#include <lm/util/task_pool.h>
+
+namespace lm {
+
+struct execution_policy {
+
+    bool parallel;
+    bool vectorized;
+
+    // maximal count of threads, including calling one, `0` means concurrency of pool
+    size_t threads;
+
+    // minimal count of iterations of split loop per thread
+    size_t grain;
+
+    // pool which runs parallel parts, `nullptr` means `task_pool::instance()`
+    task_pool* pool;
+
+    constexpr execution_policy with_threads(size_t t) const {
+        return execution_policy{parallel, vectorized, t, grain, pool};
+    }
+
+    constexpr execution_policy with_grain(size_t g) const {
+        return execution_policy{parallel, vectorized, threads, g, pool};
+    }
+
+    /**
+     * @brief runs parallel parts on pool `p` of application instead of shared pool of library
+     */
+    constexpr execution_policy with_pool(task_pool& p) const {
+        return execution_policy{parallel, vectorized, threads, grain, &p};
+    }
+
+    task_pool& executor() const {
+        return pool != nullptr ? *pool : task_pool::instance();
+    }
+
+    size_t thread_count() const {
+        if (!parallel) {
+            return 1;
+        }
+        if (threads != 0) {
+            return threads;
+        }
+        return pool != nullptr ? pool->concurrency() : hardware_threads();
+    }
+
+    // queried once, as query reads system files on some platforms
+    static size_t hardware_threads() {
+        static const size_t count = std::thread::hardware_concurrency() != 0 ? std::thread::hardware_concurrency() : 1;
+        return count;
+    }
+
+};
+
+namespace execution {
+
+constexpr execution_policy seq = { false, false, 1, 1, nullptr };
+constexpr execution_policy par = { true, false, 0, 16, nullptr };
+constexpr execution_policy simd = { false, true, 1, 1, nullptr };
+constexpr execution_policy par_simd = { true, true, 0, 16, nullptr };
+
+}
+
+/**
+ * @brief `true` on threads which run ranges of `parallel_for`
+ */
+inline bool& in_parallel_region() {
+    thread_local bool region = false;
+    return region;
+}
+
+/**
+ * @brief Runs parts `[first, last)` of range `[begin, begin + n)` split into `parts` parts by halving them on `pool`.
+ */
+template <typename F>
+void parallel_for_parts(task_pool& pool, size_t begin, size_t n, size_t parts, size_t first, size_t last, F& f) {
+    if (last - first == 1) {
+        const bool outer = in_parallel_region();
+        in_parallel_region() = true;
+        try {
+            f(begin + n * first / parts, begin + n * last / parts);
+        } catch (...) {
+            in_parallel_region() = outer;
+            throw;
+        }
+        in_parallel_region() = outer;
+        return;
+    }
+    const size_t middle = first + (last - first) / 2;
+    pool.fork_join(
+        [&]() { parallel_for_parts(pool, begin, n, parts, first, middle, f); },
+        [&]() { parallel_for_parts(pool, begin, n, parts, middle, last, f); });
+}
+
+/**
+ * @brief Calls `f(b, e)` for consecutive subranges `[b, e)` which cover `[begin, end)`.
+ *
+ * If `policy` is parallel, range is split into at most `policy.thread_count()` subranges of at least `policy.grain`
+ * indices, which are run on `policy.executor()` pool, calling thread runs subranges too. Calls from inside
+ * of parallel region run sequentially, so nested algorithms don't split their loops too finely.
+ * `f` must be safe to call concurrently for disjoint subranges.
+ *
+ * If `f` throws, exception is rethrown after all subranges are completed.
+ */
+template <typename F>
+void parallel_for(const execution_policy& policy, size_t begin, size_t end, F&& f) {
+    if (begin >= end) {
+        return;
+    }
+
+    const size_t n = end - begin;
+    const size_t grain = policy.grain != 0 ? policy.grain : 1;
+    size_t parts = policy.parallel && n / grain > 1 && !in_parallel_region() ? policy.thread_count() : 1;
+    if (parts > n / grain) {
+        parts = n / grain;
+    }
+    if (parts <= 1) {
+        f(begin, end);
+        return;
+    }
+    parallel_for_parts(policy.executor(), begin, n, parts, 0, parts, f);
+}
+
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <type_traits>
 
 namespace lm {
@@ -16,6 +17,24 @@ OIter transform(Iter1 begin1, Iter1 end1, Iter2 begin2, Iter2 end2, OIter out, F
     return out;
 }
 
+/**
+ * @brief applies `func` to first `n` elements of two ranges
+ *
+ * Unlike `transform()` checks only one bound, so number of iterations is known before loop,
+ * which allows compiler to vectorize it.
+ */
+template <typename Iter1, typename Iter2, typename OIter, typename Func>
+OIter transform_n(Iter1 begin1, size_t n, Iter2 begin2, OIter out, Func func) {
+
+    for (size_t i = 0; i < n; i++) {
+        *out = func(*begin1, *begin2);
+        ++begin1;
+        ++begin2;
+        ++out;
+    }
+    return out;
+}
+
 struct return_2nd {
 
     template <typename T1, typename T2>
@@ -0,0 +1,218 @@
+/**
+ * @file
+ * @brief Compact 16-bit floating point element types
+ *
+ * `half` is IEEE 754 binary16 (5 bit exponent, 10 bit mantissa),
+ * `bfloat16` is upper half of IEEE 754 binary32 (8 bit exponent, 7 bit mantissa).
+ *
+ * Both types are converted to `float` for arithmetic, results are rounded to nearest even when stored.
+ * Bulk conversions use F16C/AVX2 instructions when compiler targets them (e.g. `-mf16c`, `-mavx2`).
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__F16C__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace lm {
+
+inline uint32_t float_bits(float f) {
+    uint32_t u;
+    std::memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+inline float bits_float(uint32_t u) {
+    float f;
+    std::memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+/**
+ * @brief converts `float` to binary16 bits rounding to nearest even
+ */
+inline uint16_t float_to_half_bits(float value) {
+    const uint32_t f16_overflow = (127 + 16) << 23;
+    const uint32_t f16_min_normal = (127 - 14) << 23;
+    const uint32_t denormal_magic = ((127 - 15) + (23 - 10) + 1) << 23;
+
+    uint32_t u = float_bits(value);
+    const uint32_t sign = u & 0x80000000u;
+    u ^= sign;
+
+    uint16_t h;
+    if (u >= f16_overflow) {
+        h = u > 0x7f800000u ? 0x7e00 : 0x7c00;
+    } else if (u < f16_min_normal) {
+        h = static_cast<uint16_t>(float_bits(bits_float(u) + bits_float(denormal_magic)) - denormal_magic);
+    } else {
+        const uint32_t odd = (u >> 13) & 1;
+        u += (static_cast<uint32_t>(15 - 127) << 23) + 0xfff + odd;
+        h = static_cast<uint16_t>(u >> 13);
+    }
+    return static_cast<uint16_t>(h | (sign >> 16));
+}
+
+/**
+ * @brief converts binary16 bits to `float`, conversion is exact
+ */
+inline float half_bits_to_float(uint16_t h) {
+    const uint32_t shifted_exp = 0x7c00u << 13;
+    const float denormal_magic = bits_float(113u << 23);
+
+    uint32_t u = (h & 0x7fffu) << 13;
+    const uint32_t exp = u & shifted_exp;
+    u += (127 - 15) << 23;
+    if (exp == shifted_exp) {
+        u += (128 - 16) << 23;
+    } else if (exp == 0) {
+        u = float_bits(bits_float(u + (1 << 23)) - denormal_magic);
+    }
+    return bits_float(u | (static_cast<uint32_t>(h & 0x8000u) << 16));
+}
+
+/**
+ * @brief converts `float` to bfloat16 bits rounding to nearest even, NaNs stay quiet NaNs
+ */
+inline uint16_t float_to_bfloat16_bits(float value) {
+    const uint32_t u = float_bits(value);
+    if ((u & 0x7fffffffu) > 0x7f800000u) {
+        return static_cast<uint16_t>((u >> 16) | 0x40);
+    }
+    return static_cast<uint16_t>((u + 0x7fffu + ((u >> 16) & 1)) >> 16);
+}
+
+inline float bfloat16_bits_to_float(uint16_t b) {
+    return bits_float(static_cast<uint32_t>(b) << 16);
+}
+
+/**
+ * @brief 16-bit floating point number stored as bits of format `Format`
+ *
+ * Implicitly converts from any arithmetic type and to `float`, so it may be used as `value_type` of any storage.
+ * Type is trivial, so default constructed value is uninitialized (like `float`).
+ */
+template <typename Format>
+class compact_float {
+public:
+
+    compact_float() = default;
+
+    template <typename T, typename = typename std::enable_if<std::is_arithmetic<T>::value>::type>
+    compact_float(T value) : _bits(Format::from_float(static_cast<float>(value))) {}
+
+    operator float() const {
+        return Format::to_float(_bits);
+    }
+
+    static compact_float from_bits(uint16_t bits) {
+        compact_float r;
+        r._bits = bits;
+        return r;
+    }
+
+    uint16_t bits() const {
+        return _bits;
+    }
+
+    template <typename T>
+    compact_float& operator+=(const T& other) {
+        return *this = static_cast<float>(*this) + other;
+    }
+
+    template <typename T>
+    compact_float& operator-=(const T& other) {
+        return *this = static_cast<float>(*this) - other;
+    }
+
+    template <typename T>
+    compact_float& operator*=(const T& other) {
+        return *this = static_cast<float>(*this) * other;
+    }
+
+    template <typename T>
+    compact_float& operator/=(const T& other) {
+        return *this = static_cast<float>(*this) / other;
+    }
+
+private:
+    uint16_t _bits;
+};
+
+struct half_format {
+    static uint16_t from_float(float f) { return float_to_half_bits(f); }
+    static float to_float(uint16_t h) { return half_bits_to_float(h); }
+};
+
+struct bfloat16_format {
+    static uint16_t from_float(float f) { return float_to_bfloat16_bits(f); }
+    static float to_float(uint16_t b) { return bfloat16_bits_to_float(b); }
+};
+
+typedef compact_float<half_format> half;
+typedef compact_float<bfloat16_format> bfloat16;
+
+static_assert(sizeof(half) == 2 && std::is_trivial<half>::value, "half must be trivial 16-bit type");
+static_assert(sizeof(bfloat16) == 2 && std::is_trivial<bfloat16>::value, "bfloat16 must be trivial 16-bit type");
+
+/**
+ * @brief converts `n` elements from `src` to `dst`
+ */
+template <typename S, typename D>
+void convert_elements(const S* src, D* dst, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        dst[i] = static_cast<D>(src[i]);
+    }
+}
+
+inline void convert_elements(const half* src, float* dst, size_t n) {
+    size_t i = 0;
+#if defined(__F16C__)
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i))));
+    }
+#endif
+    for (; i < n; i++) {
+        dst[i] = half_bits_to_float(src[i].bits());
+    }
+}
+
+inline void convert_elements(const float* src, half* dst, size_t n) {
+    size_t i = 0;
+#if defined(__F16C__)
+    for (; i + 8 <= n; i += 8) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+            _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+    }
+#endif
+    for (; i < n; i++) {
+        dst[i] = half::from_bits(float_to_half_bits(src[i]));
+    }
+}
+
+inline void convert_elements(const bfloat16* src, float* dst, size_t n) {
+    size_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 8 <= n; i += 8) {
+        const __m256i wide = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+        _mm256_storeu_ps(dst + i, _mm256_castsi256_ps(_mm256_slli_epi32(wide, 16)));
+    }
+#endif
+    for (; i < n; i++) {
+        dst[i] = bfloat16_bits_to_float(src[i].bits());
+    }
+}
+
+inline void convert_elements(const float* src, bfloat16* dst, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        dst[i] = bfloat16::from_bits(float_to_bfloat16_bits(src[i]));
+    }
+}
+
+}
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <string>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace lm {
+
+/**
+ * @brief how file contents are mapped into memory
+ *
+ * `read_only` mapping is private (copy-on-write): matrix cells may still be written, but changes never reach the file.
+ * `read_write` mapping is shared: all changes are written back to the file.
+ */
+enum class access_mode {
+    read_only,
+    read_write
+};
+
+/**
+ * @brief expected access pattern, passed to `madvise`
+ */
+enum class access_pattern {
+    normal,
+    sequential,
+    random,
+    will_need,
+    dont_need
+};
+
+/**
+ * @brief RAII wrapper around POSIX file memory mapping
+ */
+class mapped_file {
+public:
+
+    mapped_file() : _data(nullptr), _size(0), _mode(access_mode::read_only) {}
+
+    /**
+     * @brief maps whole existing file
+     * @param path file path
+     * @param mode access mode
+     */
+    mapped_file(const std::string& path, access_mode mode) : mapped_file() {
+        const int fd = ::open(path.c_str(), mode == access_mode::read_write ? O_RDWR : O_RDONLY);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "can't open " + path);
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            const int err = errno;
+            ::close(fd);
+            throw std::system_error(err, std::generic_category(), "can't stat " + path);
+        }
+        map(fd, static_cast<size_t>(st.st_size), mode, path);
+    }
+
+    /**
+     * @brief creates (or truncates) file of given size and maps it for reading and writing
+     * @param path file path
+     * @param size file size in bytes
+     */
+    mapped_file(const std::string& path, size_t size) : mapped_file() {
+        const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "can't create " + path);
+        }
+        if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            const int err = errno;
+            ::close(fd);
+            throw std::system_error(err, std::generic_category(), "can't resize " + path);
+        }
+        map(fd, size, access_mode::read_write, path);
+    }
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    mapped_file(mapped_file&& other) : _data(other._data), _size(other._size), _mode(other._mode) {
+        other._data = nullptr;
+        other._size = 0;
+    }
+
+    mapped_file& operator=(mapped_file&& other) {
+        if (this != &other) {
+            close();
+            std::swap(_data, other._data);
+            std::swap(_size, other._size);
+            _mode = other._mode;
+        }
+        return *this;
+    }
+
+    ~mapped_file() {
+        close();
+    }
+
+    void* data() const {
+        return _data;
+    }
+
+    size_t size() const {
+        return _size;
+    }
+
+    access_mode mode() const {
+        return _mode;
+    }
+
+    /**
+     * @brief gives kernel a hint about expected access pattern of a mapped range
+     * @param pattern access pattern
+     * @param offset range offset in bytes (rounded down to page boundary)
+     * @param length range length in bytes, by default - up to the end of mapping
+     */
+    void advise(access_pattern pattern, size_t offset = 0, size_t length = static_cast<size_t>(-1)) const {
+        if (_data == nullptr || offset >= _size) {
+            return;
+        }
+        const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        const size_t begin = offset - offset % page;
+        const size_t end = length >= _size - offset ? _size : offset + length;
+        ::madvise(static_cast<char*>(_data) + begin, end - begin, to_advice(pattern));
+    }
+
+    /**
+     * @brief flushes changes of `read_write` mapping to the file
+     */
+    void sync() const {
+        if (_data != nullptr && _mode == access_mode::read_write && ::msync(_data, _size, MS_SYNC) != 0) {
+            throw std::system_error(errno, std::generic_category(), "msync failed");
+        }
+    }
+
+    void close() {
+        if (_data != nullptr) {
+            ::munmap(_data, _size);
+            _data = nullptr;
+            _size = 0;
+        }
+    }
+
+private:
+
+    void map(int fd, size_t size, access_mode mode, const std::string& path) {
+        void* data = size == 0 ? nullptr : ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+            mode == access_mode::read_write ? MAP_SHARED : MAP_PRIVATE, fd, 0);
+        const int err = errno;
+        ::close(fd);
+        if (data == MAP_FAILED) {
+            throw std::system_error(err, std::generic_category(), "can't map " + path);
+        }
+        _data = data;
+        _size = size;
+        _mode = mode;
+    }
+
+    static int to_advice(access_pattern pattern) {
+        switch (pattern) {
+        case access_pattern::sequential: return MADV_SEQUENTIAL;
+        case access_pattern::random: return MADV_RANDOM;
+        case access_pattern::will_need: return MADV_WILLNEED;
+        case access_pattern::dont_need: return MADV_DONTNEED;
+        default: return MADV_NORMAL;
+        }
+    }
+
+    void* _data;
+    size_t _size;
+    access_mode _mode;
+
+};
+
+}
@@ -0,0 +1,297 @@
+/**
+ * @file
+ * @brief Hardware performance counters of algorithm calls
+ *
+ * Algorithm entry points are wrapped by `LM_PERF_SCOPE` which measures cycles, instructions, last level cache misses
+ * and branch misses of the calling thread through Linux `perf_event_open` and adds them to `perf_registry`.
+ * Counts are aggregated per operation and shape bucket (dimensions rounded up to power of two).
+ * When kernel multiplexes counters (more events are requested than hardware counters are available), counts are
+ * extrapolated from the time the group was running to the time it was enabled, as by `perf stat`.
+ *
+ * Instrumentation is enabled by defining `LM_PERF_COUNTERS`, otherwise `LM_PERF_SCOPE` expands to nothing.
+ * If counters can't be opened (not Linux, restricted `perf_event_paranoid`, seccomp) only calls are counted.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace lm {
+
+enum class perf_event {
+    cycles,
+    instructions,
+    llc_misses,
+    branch_misses
+};
+
+struct perf_counts {
+
+    static const size_t event_count = 4;
+
+    uint64_t calls = 0;
+    uint64_t values[event_count] = {};
+
+    uint64_t operator[](perf_event e) const {
+        return values[static_cast<size_t>(e)];
+    }
+
+    perf_counts& operator+=(const perf_counts& other) {
+        calls += other.calls;
+        for (size_t i = 0; i < event_count; i++) {
+            values[i] += other.values[i];
+        }
+        return *this;
+    }
+
+    /**
+     * @brief instructions per cycle, low values of compute kernels usually mean that kernel is memory-bound
+     */
+    double ipc() const {
+        const uint64_t c = (*this)[perf_event::cycles];
+        return c > 0 ? static_cast<double>((*this)[perf_event::instructions]) / static_cast<double>(c) : 0;
+    }
+
+};
+
+/**
+ * @brief Extrapolates `count` measured while counters were running to the whole time they were enabled.
+ *
+ * @return `count` if counters weren't multiplexed, `0` if they weren't running at all
+ */
+inline uint64_t scale_multiplexed(uint64_t count, uint64_t time_enabled, uint64_t time_running) {
+    if (time_running == 0) {
+        return 0;
+    }
+    if (time_running >= time_enabled) {
+        return count;
+    }
+    return static_cast<uint64_t>(static_cast<double>(count) * static_cast<double>(time_enabled) / static_cast<double>(time_running));
+}
+
+/**
+ * @brief raw values of counters with times the group was enabled and running, in nanoseconds
+ */
+struct perf_sample {
+    uint64_t time_enabled = 0;
+    uint64_t time_running = 0;
+    uint64_t values[perf_counts::event_count] = {};
+};
+
+/**
+ * @brief group of counters of calling thread, opened once and kept enabled
+ *
+ * Counters are opened without `inherit`, so they count only the thread which opened them.
+ */
+class perf_counter_group {
+public:
+
+    perf_counter_group() {
+#if defined(__linux__)
+        static const uint64_t configs[perf_counts::event_count] = {
+            PERF_COUNT_HW_CPU_CYCLES,
+            PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_MISSES,
+            PERF_COUNT_HW_BRANCH_MISSES
+        };
+        for (size_t i = 0; i < perf_counts::event_count; i++) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.size = sizeof(attr);
+            attr.config = configs[i];
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            attr.disabled = i == 0 ? 1 : 0;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            _fd[i] = static_cast<int>(::syscall(__NR_perf_event_open, &attr, 0, -1, i == 0 ? -1 : _fd[0], 0));
+            if (_fd[i] < 0) {
+                close_all();
+                return;
+            }
+        }
+        ::ioctl(_fd[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ::ioctl(_fd[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    perf_counter_group(const perf_counter_group&) = delete;
+    perf_counter_group& operator=(const perf_counter_group&) = delete;
+
+    ~perf_counter_group() {
+        close_all();
+    }
+
+    bool available() const {
+        return _fd[0] >= 0;
+    }
+
+    /**
+     * @brief reads current counter values and times, all zero if counters are unavailable
+     */
+    void read(perf_sample& sample) const {
+        sample = perf_sample();
+#if defined(__linux__)
+        if (!available()) {
+            return;
+        }
+        // count of events, time enabled, time running and values of events
+        uint64_t buf[3 + perf_counts::event_count];
+        if (::read(_fd[0], buf, sizeof(buf)) == static_cast<ssize_t>(sizeof(buf))) {
+            sample.time_enabled = buf[1];
+            sample.time_running = buf[2];
+            for (size_t i = 0; i < perf_counts::event_count && i < buf[0]; i++) {
+                sample.values[i] = buf[3 + i];
+            }
+        }
+#endif
+    }
+
+    /**
+     * @brief counters of calling thread
+     */
+    static perf_counter_group& current() {
+        thread_local perf_counter_group group;
+        return group;
+    }
+
+private:
+
+    void close_all() {
+        for (int& fd : _fd) {
+            if (fd >= 0) {
+#if defined(__linux__)
+                ::close(fd);
+#endif
+                fd = -1;
+            }
+        }
+    }
+
+    int _fd[perf_counts::event_count] = { -1, -1, -1, -1 };
+
+};
+
+/**
+ * @brief rounds `n` up to power of two, used to group calls by shape
+ */
+inline size_t shape_bucket(size_t n) {
+    size_t b = 1;
+    while (b < n) {
+        b <<= 1;
+    }
+    return b;
+}
+
+struct perf_record {
+    const char* operation;
+    size_t rows;
+    size_t cols;
+    perf_counts counts;
+};
+
+/**
+ * @brief process-wide aggregated counts
+ */
+class perf_registry {
+public:
+
+    static perf_registry& instance() {
+        static perf_registry registry;
+        return registry;
+    }
+
+    void add(const char* operation, size_t rows, size_t cols, const perf_counts& counts) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _counts[key(operation, shape_bucket(rows), shape_bucket(cols))] += counts;
+    }
+
+    /**
+     * @brief copy of aggregated counts ordered by operation and shape bucket
+     */
+    std::vector<perf_record> snapshot() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::vector<perf_record> records;
+        for (const auto& c : _counts) {
+            records.push_back(perf_record{std::get<0>(c.first), std::get<1>(c.first), std::get<2>(c.first), c.second});
+        }
+        return records;
+    }
+
+    void reset() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _counts.clear();
+    }
+
+private:
+
+    typedef std::tuple<const char*, size_t, size_t> key;
+
+    struct key_less {
+        bool operator()(const key& a, const key& b) const {
+            const int c = std::strcmp(std::get<0>(a), std::get<0>(b));
+            return c != 0 ? c < 0 : std::tie(std::get<1>(a), std::get<2>(a)) < std::tie(std::get<1>(b), std::get<2>(b));
+        }
+    };
+
+    mutable std::mutex _mutex;
+    std::map<key, perf_counts, key_less> _counts;
+
+};
+
+/**
+ * @brief measures counters from construction to destruction and adds them to `perf_registry`
+ *
+ * Scopes may nest, so counts of an operation include counts of operations it calls.
+ */
+class perf_scope {
+public:
+
+    perf_scope(const char* operation, size_t rows, size_t cols) : _operation(operation), _rows(rows), _cols(cols) {
+        perf_counter_group::current().read(_start);
+    }
+
+    perf_scope(const perf_scope&) = delete;
+    perf_scope& operator=(const perf_scope&) = delete;
+
+    ~perf_scope() {
+        perf_sample end;
+        perf_counter_group::current().read(end);
+
+        perf_counts counts;
+        counts.calls = 1;
+        for (size_t i = 0; i < perf_counts::event_count; i++) {
+            counts.values[i] = scale_multiplexed(end.values[i] - _start.values[i],
+                end.time_enabled - _start.time_enabled, end.time_running - _start.time_running);
+        }
+        perf_registry::instance().add(_operation, _rows, _cols, counts);
+    }
+
+private:
+    const char* _operation;
+    size_t _rows;
+    size_t _cols;
+    perf_sample _start;
+};
+
+}
+
+// counters of calling thread only: with parallel policies work done by workers of pool isn't counted
+#if defined(LM_PERF_COUNTERS)
+#define LM_PERF_SCOPE(operation, rows, cols) ::lm::perf_scope lm_perf_scope_((operation), (rows), (cols))
+#else
+#define LM_PERF_SCOPE(operation, rows, cols)
+#endif
@@ -0,0 +1,93 @@
+/**
+ * @file
+ * @brief Reductions with order of summation fixed regardless of execution policy
+ *
+ * Range is split into blocks of `reduce_block_size` terms, which are summed by 4 interleaved
+ * accumulators, and sums of blocks are added by pairwise tree formed by halving of range of blocks.
+ * Shape of tree depends only on count of terms, threads only take whole subtrees, so result is bit-identical
+ * for any count of threads, pool and for sequential run.
+ *
+ * Pairwise summation also bounds rounding error by @f$ O(\log n) @f$ instead of @f$ O(n) @f$ of running sum,
+ * while interleaved accumulators of blocks keep sequential loop vectorizable.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include <lm/util/execution.h>
+
+namespace lm {
+
+constexpr size_t reduce_block_size = 256;
+
+/**
+ * @brief sums `term(i)` for `i` in `[begin, end)`, at most `reduce_block_size` terms
+ */
+template <typename Acc, typename F>
+Acc reduce_block(size_t begin, size_t end, F& term) {
+    Acc lanes[4] = { Acc(), Acc(), Acc(), Acc() };
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        lanes[0] += term(i);
+        lanes[1] += term(i + 1);
+        lanes[2] += term(i + 2);
+        lanes[3] += term(i + 3);
+    }
+    for (size_t l = 0; i < end; i++, l++) {
+        lanes[l] += term(i);
+    }
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+/**
+ * @brief sums blocks `[first, last)` of `n` terms, up to `parts` subtrees are run in parallel on `pool`
+ */
+template <typename Acc, typename F>
+Acc reduce_blocks(task_pool* pool, size_t parts, size_t n, size_t first, size_t last, F& term) {
+    if (last - first == 1) {
+        const size_t end = (first + 1) * reduce_block_size;
+        return reduce_block<Acc>(first * reduce_block_size, end < n ? end : n, term);
+    }
+    const size_t middle = first + (last - first) / 2;
+    Acc left = Acc(), right = Acc();
+    if (parts > 1) {
+        pool->fork_join(
+            [&]() { left = reduce_blocks<Acc>(pool, parts / 2, n, first, middle, term); },
+            [&]() { right = reduce_blocks<Acc>(pool, parts - parts / 2, n, middle, last, term); });
+    } else {
+        left = reduce_blocks<Acc>(pool, 1, n, first, middle, term);
+        right = reduce_blocks<Acc>(pool, 1, n, middle, last, term);
+    }
+    return left + right;
+}
+
+/**
+ * @brief Computes sum of `term(i)` for `i` in `[0, n)` in order which doesn't depend on `policy`.
+ *
+ * Parallel policy runs subtrees of at least `policy.grain` blocks on up to `policy.thread_count()` threads.
+ * `term` must be safe to call concurrently.
+ *
+ * @tparam Acc type of accumulator, `term` must return value convertible to it
+ * @param policy execution policy
+ * @param n count of terms
+ * @param term function which returns `i`-th term
+ * @return sum of terms, bit-identical for any policy
+ */
+template <typename Acc, typename F>
+Acc reproducible_sum(const execution_policy& policy, size_t n, F&& term) {
+    auto acc_term = [&term](size_t i) { return static_cast<Acc>(term(i)); };
+    if (n <= reduce_block_size) {
+        return reduce_block<Acc>(0, n, acc_term);
+    }
+    const size_t blocks = (n + reduce_block_size - 1) / reduce_block_size;
+    const size_t grain = policy.grain != 0 ? policy.grain : 1;
+    size_t parts = policy.parallel && blocks / grain > 1 && !in_parallel_region() ? policy.thread_count() : 1;
+    if (parts > blocks / grain) {
+        parts = blocks / grain;
+    }
+    // pool isn't touched by sequential runs
+    return reduce_blocks<Acc>(parts > 1 ? &policy.executor() : nullptr, parts, n, 0, blocks, acc_term);
+}
+
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <type_traits>
+
+namespace lm {
+
+/**
+ * @brief resizable array which keeps up to `N` elements inside object and allocates heap memory only for bigger sizes
+ *
+ * Only trivially copyable elements are supported.
+ */
+template <typename T, size_t N>
+class small_vector {
+public:
+
+    static_assert(std::is_trivially_copyable<T>::value, "small_vector supports only trivially copyable types");
+
+    typedef T value_type;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+
+    constexpr static size_t inline_capacity = N;
+
+    small_vector() : _data(_inline), _size(0), _capacity(N) {}
+
+    explicit small_vector(size_t size) : small_vector() {
+        resize(size);
+    }
+
+    small_vector(std::initializer_list<T> values) : small_vector() {
+        assign(values.begin(), values.size());
+    }
+
+    small_vector(const small_vector& other) : small_vector() {
+        assign(other._data, other._size);
+    }
+
+    // heap memory is taken over, inline elements are copied
+    small_vector(small_vector&& other) : small_vector() {
+        take(other);
+    }
+
+    small_vector& operator=(const small_vector& other) {
+        if (this != &other) {
+            assign(other._data, other._size);
+        }
+        return *this;
+    }
+
+    small_vector& operator=(small_vector&& other) {
+        if (this != &other) {
+            _heap.reset();
+            _data = _inline;
+            _capacity = N;
+            take(other);
+        }
+        return *this;
+    }
+
+    size_t size() const { return _size; }
+    size_t capacity() const { return _capacity; }
+    bool empty() const { return _size == 0; }
+
+    /**
+     * @brief `true` if elements are stored inside object
+     */
+    bool is_inline() const { return _data == _inline; }
+
+    T* data() { return _data; }
+    const T* data() const { return _data; }
+
+    T& operator[](size_t idx) { return _data[idx]; }
+    const T& operator[](size_t idx) const { return _data[idx]; }
+
+    iterator begin() { return _data; }
+    iterator end() { return _data + _size; }
+    const_iterator begin() const { return _data; }
+    const_iterator end() const { return _data + _size; }
+
+    /**
+     * @brief changes size, existing elements are kept, new elements are value-initialized
+     */
+    void resize(size_t size) {
+        reserve(size);
+        std::fill(_data + std::min(_size, size), _data + size, T());
+        _size = size;
+    }
+
+    void reserve(size_t capacity) {
+        if (capacity <= _capacity) {
+            return;
+        }
+        capacity = std::max(capacity, 2 * _capacity);
+        std::unique_ptr<T[]> heap(new T[capacity]);
+        std::memcpy(heap.get(), _data, _size * sizeof(T));
+        _heap = std::move(heap);
+        _data = _heap.get();
+        _capacity = capacity;
+    }
+
+private:
+
+    void assign(const T* values, size_t size) {
+        _size = 0;
+        reserve(size);
+        std::memcpy(_data, values, size * sizeof(T));
+        _size = size;
+    }
+
+    void take(small_vector& other) {
+        if (other.is_inline()) {
+            assign(other._data, other._size);
+        } else {
+            _heap = std::move(other._heap);
+            _data = _heap.get();
+            _size = other._size;
+            _capacity = other._capacity;
+            other._data = other._inline;
+            other._capacity = N;
+        }
+        other._size = 0;
+    }
+
+    T _inline[N];
+    std::unique_ptr<T[]> _heap;
+    T* _data;
+    size_t _size;
+    size_t _capacity;
+
+};
+
+}
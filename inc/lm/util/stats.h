@@ -0,0 +1,307 @@
+/**
+ * @file
+ * @brief Operation counters of algorithm calls
+ *
+ * Algorithm entry points are wrapped by `LM_STATS_SCOPE` which counts calls, floating point operations and wall time
+ * per operation and size class. Temporary memory allocated by `arena_allocator` is reported by `LM_STATS_ALLOCATE`
+ * and counted for the innermost operation in progress.
+ *
+ * Element-wise `+`, `-`, `+=` and `-=` of matricies are counted as `elementwise`, storage of dynamic matrix returned
+ * by `+` and `-` is counted as allocated by operation.
+ *
+ * Each thread accumulates into its own block without locking; `stats_registry::snapshot()` sums blocks of all threads.
+ * Counts are inclusive, i.e. `invert_matrix` also counts as `lu_decomposition` and `lu_substitute`.
+ *
+ * Instrumentation is enabled by defining `LM_STATS`, otherwise `LM_STATS_SCOPE` and `LM_STATS_ALLOCATE` expand to nothing.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace lm {
+
+enum class stats_operation {
+    product,
+    transpose,
+    lu_decomposition,
+    lu_substitute,
+    invert_matrix,
+    determinant,
+    solve,
+    elementwise
+};
+
+const size_t stats_operation_count = 8;
+
+/**
+ * @brief count of size classes, class `c > 0` holds shapes with largest dimension in @f$ [2^{c-1}, 2^c) @f$
+ */
+const size_t stats_size_class_count = 33;
+
+inline const char* stats_operation_name(stats_operation op) {
+    static const char* names[stats_operation_count] = {
+        "product", "transpose", "lu_decomposition", "lu_substitute", "invert_matrix", "determinant", "solve", "elementwise"
+    };
+    return names[static_cast<size_t>(op)];
+}
+
+inline size_t stats_size_class(size_t rows, size_t cols) {
+    size_t n = rows > cols ? rows : cols, c = 0;
+    while (n != 0 && c + 1 < stats_size_class_count) {
+        n >>= 1;
+        c++;
+    }
+    return c;
+}
+
+struct stats_counts {
+
+    uint64_t calls = 0;
+    uint64_t flops = 0;
+    uint64_t allocated_bytes = 0;
+    uint64_t nanoseconds = 0;
+
+    bool empty() const {
+        return calls == 0 && allocated_bytes == 0;
+    }
+
+};
+
+struct stats_record {
+    stats_operation operation;
+    size_t size_class;
+    stats_counts counts;
+};
+
+/**
+ * @brief counters of single thread, written only by owning thread and read by any
+ */
+class thread_stats {
+public:
+
+    enum field {
+        calls,
+        flops,
+        allocated_bytes,
+        nanoseconds,
+        field_count
+    };
+
+    thread_stats() {
+        for (auto& v : _values) {
+            v.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    thread_stats(const thread_stats&) = delete;
+    thread_stats& operator=(const thread_stats&) = delete;
+
+    /**
+     * @brief adds `value` to counter, plain load and store are enough since there is single writer
+     */
+    void add(stats_operation op, size_t size_class, field f, uint64_t value) {
+        std::atomic<uint64_t>& v = _values[index(op, size_class, f)];
+        v.store(v.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    uint64_t get(stats_operation op, size_t size_class, field f) const {
+        return _values[index(op, size_class, f)].load(std::memory_order_relaxed);
+    }
+
+private:
+
+    static size_t index(stats_operation op, size_t size_class, field f) {
+        return (static_cast<size_t>(op) * stats_size_class_count + size_class) * field_count + f;
+    }
+
+    std::atomic<uint64_t> _values[stats_operation_count * stats_size_class_count * field_count];
+
+};
+
+/**
+ * @brief process-wide view of counters of all threads
+ */
+class stats_registry {
+public:
+
+    static stats_registry& instance() {
+        static stats_registry registry;
+        return registry;
+    }
+
+    /**
+     * @brief counters of calling thread
+     */
+    static thread_stats& current() {
+        thread_local registration r(instance());
+        return r.stats;
+    }
+
+    /**
+     * @brief counts accumulated since last `reset()`, only non-empty records are returned
+     */
+    std::vector<stats_record> snapshot() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::vector<stats_record> records;
+        std::vector<uint64_t> totals = sum();
+        for (size_t op = 0; op < stats_operation_count; op++) {
+            for (size_t c = 0; c < stats_size_class_count; c++) {
+                const size_t i = (op * stats_size_class_count + c) * thread_stats::field_count;
+                stats_record r;
+                r.operation = static_cast<stats_operation>(op);
+                r.size_class = c;
+                r.counts.calls = totals[i + thread_stats::calls] - _baseline[i + thread_stats::calls];
+                r.counts.flops = totals[i + thread_stats::flops] - _baseline[i + thread_stats::flops];
+                r.counts.allocated_bytes = totals[i + thread_stats::allocated_bytes] - _baseline[i + thread_stats::allocated_bytes];
+                r.counts.nanoseconds = totals[i + thread_stats::nanoseconds] - _baseline[i + thread_stats::nanoseconds];
+                if (!r.counts.empty()) {
+                    records.push_back(r);
+                }
+            }
+        }
+        return records;
+    }
+
+    /**
+     * @brief counts of operation `op` summed over all size classes
+     */
+    stats_counts total(stats_operation op) const {
+        stats_counts t;
+        for (const stats_record& r : snapshot()) {
+            if (r.operation == op) {
+                t.calls += r.counts.calls;
+                t.flops += r.counts.flops;
+                t.allocated_bytes += r.counts.allocated_bytes;
+                t.nanoseconds += r.counts.nanoseconds;
+            }
+        }
+        return t;
+    }
+
+    /**
+     * @brief starts counting from zero, counters of threads are not modified so writers never synchronize
+     */
+    void reset() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _baseline = sum();
+    }
+
+private:
+
+    static const size_t value_count = stats_operation_count * stats_size_class_count * thread_stats::field_count;
+
+    struct registration {
+        explicit registration(stats_registry& r) : registry(r) {
+            std::lock_guard<std::mutex> lock(registry._mutex);
+            registry._threads.push_back(&stats);
+        }
+
+        ~registration() {
+            std::lock_guard<std::mutex> lock(registry._mutex);
+            registry.add(stats, registry._retired);
+            for (size_t i = 0; i < registry._threads.size(); i++) {
+                if (registry._threads[i] == &stats) {
+                    registry._threads.erase(registry._threads.begin() + static_cast<std::ptrdiff_t>(i));
+                    break;
+                }
+            }
+        }
+
+        stats_registry& registry;
+        thread_stats stats;
+    };
+
+    stats_registry() : _retired(value_count), _baseline(value_count) {}
+
+    static void add(const thread_stats& s, std::vector<uint64_t>& values) {
+        for (size_t op = 0; op < stats_operation_count; op++) {
+            for (size_t c = 0; c < stats_size_class_count; c++) {
+                for (size_t f = 0; f < thread_stats::field_count; f++) {
+                    values[(op * stats_size_class_count + c) * thread_stats::field_count + f] +=
+                        s.get(static_cast<stats_operation>(op), c, static_cast<thread_stats::field>(f));
+                }
+            }
+        }
+    }
+
+    std::vector<uint64_t> sum() const {
+        std::vector<uint64_t> values(_retired);
+        for (const thread_stats* s : _threads) {
+            add(*s, values);
+        }
+        return values;
+    }
+
+    mutable std::mutex _mutex;
+    std::vector<thread_stats*> _threads;
+
+    // counters of finished threads
+    std::vector<uint64_t> _retired;
+    std::vector<uint64_t> _baseline;
+
+};
+
+/**
+ * @brief counts single call of operation from construction to destruction
+ */
+class stats_scope {
+public:
+
+    stats_scope(stats_operation op, size_t rows, size_t cols, uint64_t flops) :
+        _op(op), _size_class(stats_size_class(rows, cols)), _prev(current()),
+        _start(std::chrono::steady_clock::now())
+    {
+        thread_stats& s = stats_registry::current();
+        s.add(_op, _size_class, thread_stats::calls, 1);
+        s.add(_op, _size_class, thread_stats::flops, flops);
+        current() = this;
+    }
+
+    stats_scope(const stats_scope&) = delete;
+    stats_scope& operator=(const stats_scope&) = delete;
+
+    ~stats_scope() {
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _start);
+        stats_registry::current().add(_op, _size_class, thread_stats::nanoseconds, static_cast<uint64_t>(ns.count()));
+        current() = _prev;
+    }
+
+    /**
+     * @brief counts `bytes` of temporary memory for innermost operation in progress, ignored outside of operations
+     */
+    static void allocated(size_t bytes) {
+        const stats_scope* s = current();
+        if (s != nullptr) {
+            stats_registry::current().add(s->_op, s->_size_class, thread_stats::allocated_bytes, bytes);
+        }
+    }
+
+private:
+
+    static const stats_scope*& current() {
+        thread_local const stats_scope* scope = nullptr;
+        return scope;
+    }
+
+    stats_operation _op;
+    size_t _size_class;
+    const stats_scope* _prev;
+    std::chrono::steady_clock::time_point _start;
+};
+
+}
+
+#if defined(LM_STATS)
+#define LM_STATS_SCOPE(op, rows, cols, flops) \
+    ::lm::stats_scope lm_stats_scope_(::lm::stats_operation::op, (rows), (cols), static_cast<uint64_t>(flops))
+#define LM_STATS_ALLOCATE(bytes) ::lm::stats_scope::allocated(bytes)
+#else
+#define LM_STATS_SCOPE(op, rows, cols, flops)
+#define LM_STATS_ALLOCATE(bytes)
+#endif
@@ -0,0 +1,333 @@
+/**
+ * @file
+ * @brief Work-stealing pool of threads for fork/join parallelism
+ *
+ * Each worker owns bounded deque of tasks. Forked tasks are pushed to the bottom of deque of forking thread and
+ * popped back from the bottom when it joins them, idle workers steal from the top of other deques, so large
+ * subproblems of recursive algorithms are stolen first. Threads which aren't workers of pool push tasks to shared
+ * bounded queue. When deque is full task is run by forking thread, so memory used by pool never grows.
+ *
+ * Tasks are kept on stack of forking thread and joining thread executes other tasks while waiting
+ * (and sleeps when there are none), so nested `fork_join` calls don't block workers and don't allocate memory.
+ *
+ * Application may create its own pool and pass it to algorithms with `execution_policy::with_pool`,
+ * otherwise algorithms use pool returned by `task_pool::instance()` which is created on first use.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace lm {
+
+/**
+ * @brief task which is forked by `fork_join`, lives on stack of forking thread
+ */
+struct pool_task {
+
+    void (*invoke)(pool_task*);
+    std::atomic<bool> done;
+    std::exception_ptr error;
+
+    explicit pool_task(void (*f)(pool_task*)) : invoke(f), done(false) {}
+
+    void execute() {
+        try {
+            invoke(this);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        done.store(true, std::memory_order_release);
+    }
+
+};
+
+/**
+ * @brief bounded deque of tasks, owner works with the bottom and thieves take from the top
+ */
+class task_deque {
+public:
+
+    static const size_t capacity = 256;
+
+    /**
+     * @return `false` if deque is full
+     */
+    bool push(pool_task* t) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_bottom - _top == capacity) {
+            return false;
+        }
+        _tasks[_bottom++ % capacity] = t;
+        return true;
+    }
+
+    /**
+     * @brief removes task `t` if it wasn't taken yet
+     */
+    bool take(pool_task* t) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (size_t i = _bottom; i != _top; i--) {
+            if (_tasks[(i - 1) % capacity] == t) {
+                for (size_t j = i; j != _bottom; j++) {
+                    _tasks[(j - 1) % capacity] = _tasks[j % capacity];
+                }
+                _bottom--;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    pool_task* pop() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _bottom == _top ? nullptr : _tasks[--_bottom % capacity];
+    }
+
+    pool_task* steal() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _bottom == _top ? nullptr : _tasks[_top++ % capacity];
+    }
+
+private:
+    std::mutex _mutex;
+    pool_task* _tasks[capacity];
+    size_t _top = 0;
+    size_t _bottom = 0;
+};
+
+class task_pool {
+public:
+
+    /**
+     * @param workers count of worker threads, threads which join tasks also execute them,
+     *   so pool with `0` workers runs everything on calling threads
+     */
+    explicit task_pool(size_t workers) : _deques(workers), _pending(0), _joiners(0), _stop(false) {
+        _threads.reserve(workers);
+        for (size_t i = 0; i < workers; i++) {
+            _threads.emplace_back([this, i]() { work(i); });
+        }
+    }
+
+    task_pool(const task_pool&) = delete;
+    task_pool& operator=(const task_pool&) = delete;
+
+    ~task_pool() {
+        {
+            std::lock_guard<std::mutex> lock(_sleep_mutex);
+            _stop = true;
+        }
+        _wake.notify_all();
+        for (std::thread& t : _threads) {
+            t.join();
+        }
+    }
+
+    size_t workers() const {
+        return _threads.size();
+    }
+
+    /**
+     * @brief count of threads which may execute tasks at once: workers and joining thread
+     */
+    size_t concurrency() const {
+        return workers() + 1;
+    }
+
+    /**
+     * @brief shared pool with worker per hardware thread except calling one
+     */
+    static task_pool& instance() {
+        static task_pool pool(std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 0);
+        return pool;
+    }
+
+    /**
+     * @brief Runs `f1` and `f2` possibly in parallel and returns when both are completed.
+     *
+     * `f2` is offered to other threads while `f1` runs on calling thread. If any of them throws,
+     * exception is rethrown after both are completed.
+     */
+    template <typename F1, typename F2>
+    void fork_join(F1&& f1, F2&& f2) {
+        typedef typename std::remove_reference<F2>::type f2_type;
+        struct forked_task: pool_task {
+            f2_type& f;
+            explicit forked_task(f2_type& f) : pool_task(&forked_task::run), f(f) {}
+            static void run(pool_task* t) {
+                static_cast<forked_task*>(t)->f();
+            }
+        };
+
+        forked_task task(f2);
+        task_deque& d = local_deque();
+        _pending.fetch_add(1, std::memory_order_release);
+        const bool forked = d.push(&task);
+        if (forked) {
+            notify();
+        } else {
+            _pending.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        std::exception_ptr error;
+        try {
+            f1();
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        if (!forked || d.take(&task)) {
+            if (forked) {
+                _pending.fetch_sub(1, std::memory_order_relaxed);
+            }
+            task.execute();
+        } else {
+            join(task);
+        }
+
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        if (task.error) {
+            std::rethrow_exception(task.error);
+        }
+    }
+
+private:
+
+    // failed attempts to find work before joining thread goes to sleep
+    static const size_t join_spins = 64;
+
+    struct worker_context {
+        task_pool* pool;
+        size_t index;
+    };
+
+    static worker_context& context() {
+        thread_local worker_context c = { nullptr, 0 };
+        return c;
+    }
+
+    bool is_worker() const {
+        return context().pool == this;
+    }
+
+    task_deque& local_deque() {
+        return is_worker() ? _deques[context().index] : _shared;
+    }
+
+    /**
+     * @brief executes other tasks while stolen task `task` is in progress
+     *
+     * After `join_spins` failed attempts to find work thread sleeps until task is completed or new task is forked.
+     */
+    void join(pool_task& task) {
+        for (size_t idle = 0; !task.done.load(std::memory_order_acquire); ) {
+            pool_task* t = find_task();
+            if (t != nullptr) {
+                run(t);
+                idle = 0;
+            } else if (++idle < join_spins) {
+                std::this_thread::yield();
+            } else {
+                std::unique_lock<std::mutex> lock(_sleep_mutex);
+                _joiners.fetch_add(1);
+                _joined.wait(lock, [this, &task]() { return task.done.load() || _pending.load() != 0; });
+                _joiners.fetch_sub(1);
+                idle = 0;
+            }
+        }
+    }
+
+    /**
+     * @brief executes stolen task `t` and wakes threads which wait for it
+     */
+    void run(pool_task* t) {
+        t->execute();
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_joiners.load(std::memory_order_relaxed) != 0) {
+            std::lock_guard<std::mutex> lock(_sleep_mutex);
+            _joined.notify_all();
+        }
+    }
+
+    /**
+     * @brief own tasks are taken first, then tasks of other threads
+     */
+    pool_task* find_task() {
+        if (_pending.load(std::memory_order_acquire) == 0) {
+            return nullptr;
+        }
+        const size_t self = is_worker() ? context().index : _deques.size();
+        pool_task* t = self < _deques.size() ? _deques[self].pop() : nullptr;
+        if (t == nullptr) {
+            t = _shared.steal();
+        }
+        for (size_t i = 1; t == nullptr && i <= _deques.size(); i++) {
+            const size_t victim = (self + i) % (_deques.size() + 1);
+            if (victim < _deques.size()) {
+                t = _deques[victim].steal();
+            }
+        }
+        if (t != nullptr) {
+            _pending.fetch_sub(1, std::memory_order_relaxed);
+        }
+        return t;
+    }
+
+    void notify() {
+        const bool joiners = _joiners.load(std::memory_order_relaxed) != 0;
+        if (_threads.empty() && !joiners) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(_sleep_mutex);
+        _wake.notify_one();
+        if (joiners) {
+            _joined.notify_all();
+        }
+    }
+
+    void work(size_t index) {
+        context() = worker_context{ this, index };
+        while (true) {
+            pool_task* t = find_task();
+            if (t != nullptr) {
+                run(t);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(_sleep_mutex);
+            _wake.wait(lock, [this]() { return _stop || _pending.load(std::memory_order_acquire) != 0; });
+            if (_stop) {
+                return;
+            }
+        }
+    }
+
+    std::vector<task_deque> _deques;
+
+    // tasks forked by threads which aren't workers of pool
+    task_deque _shared;
+
+    std::atomic<size_t> _pending;
+
+    // count of threads which sleep in `join`
+    std::atomic<size_t> _joiners;
+
+    std::mutex _sleep_mutex;
+    std::condition_variable _wake;
+    std::condition_variable _joined;
+    bool _stop;
+
+    std::vector<std::thread> _threads;
+
+};
+
+}
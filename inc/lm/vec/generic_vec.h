@@ -6,6 +6,7 @@
 #include <cmath>
 
 #include <lm/util/functional.h>
+#include <lm/util/reduce.h>
 #include <lm/util/range.h>
 #include <lm/util/random_access_iterator.h>
 
@@ -43,17 +44,36 @@ public:
      *  @f$x^2 + y^2@f$
      *
      * @sa length()
+     * @tparam Acc type of accumulator
      * @return squared vector length
      */
-    value_type length_square() const {
-        value_type result = value_type();
+    template <typename Acc = value_type>
+    Acc length_square() const {
+        Acc result = Acc();
         for (size_t i = 0; i < base_type::size(); i++) {
-            const value_type& val = as_vec()[i];
+            const Acc val = static_cast<Acc>(as_vec()[i]);
             result += val * val;
         }
         return result;
     }
 
+    /**
+     * @brief Computes squared vector length with order of summation fixed by `reproducible_sum`.
+     *
+     * Result is bit-identical for any `policy`, but may differ from `length_square()` by rounding.
+     *
+     * @tparam Acc type of accumulator
+     * @param policy execution policy
+     * @return squared vector length
+     */
+    template <typename Acc = value_type>
+    Acc length_square(const execution_policy& policy) const {
+        return reproducible_sum<Acc>(policy, base_type::size(), [this](size_t i) {
+            const Acc val = static_cast<Acc>(as_vec()[i]);
+            return val * val;
+        });
+    }
+
     /**
      * @brief Computes vector length.
      *
@@ -64,10 +84,12 @@ public:
      *  @f$\sqrt{x^2 + y^2}@f$
      *
      * @sa length_square()
+     * @tparam Acc type of accumulator
      * @return vector length
      */
+    template <typename Acc = value_type>
     value_type length() const {
-        return static_cast<value_type>(sqrt(length_square()));
+        return static_cast<value_type>(sqrt(length_square<Acc>()));
     }
 
 
@@ -80,26 +102,47 @@ public:
      * For example if `size()` is 2 (2d vectors) this is same as:
      *  @f$x_1 * x_2 + y_1 * y_2@f$
      *
+     * @tparam Acc type of accumulator
      * @tparam Vec vector type
      * @param other product vector
      * @return scalar product of `this` and `other` vectors
      */
-    template <typename Vec>
-    value_type scalar_product(const Vec& other) {
+    template <typename Acc = value_type, typename Vec>
+    Acc scalar_product(const Vec& other) {
 
-		auto r = range(other, base_type::size());
-		auto b = base_type::begin(), e = base_type::end();
-		auto rb = r.begin(), re = r.end();
+		auto&& r = range(other, base_type::size());
+		auto b = base_type::begin();
+		auto rb = r.begin();
 
-        value_type product = value_type();
-        while (b != e && rb != re) {
-            product += (*b) * (*rb);
+        Acc product = Acc();
+        for (size_t n = std::min<size_t>(base_type::size(), r.size()); n != 0; n--) {
+            product += static_cast<Acc>(*b) * static_cast<Acc>(*rb);
             ++b;
             ++rb;
         }
         return product;
     }
 
+    /**
+     * @brief Computes scalar product of two vectors with order of summation fixed by `reproducible_sum`.
+     *
+     * Result is bit-identical for any `policy`, but may differ from `scalar_product(other)` by rounding.
+     *
+     * @tparam Acc type of accumulator
+     * @tparam Vec vector type
+     * @param policy execution policy
+     * @param other product vector
+     * @return scalar product of `this` and `other` vectors
+     */
+    template <typename Acc = value_type, typename Vec>
+    Acc scalar_product(const execution_policy& policy, const Vec& other) const {
+        auto&& r = range(other, base_type::size());
+        const size_t n = std::min<size_t>(base_type::size(), r.size());
+        return reproducible_sum<Acc>(policy, n, [&](size_t i) {
+            return static_cast<Acc>(as_vec()[i]) * static_cast<Acc>(r[i]);
+        });
+    }
+
     /**
      * @brief Assigns `this` vector to `other`.
      *
@@ -129,7 +172,7 @@ public:
      */
     template <typename Other>
     bool operator==(const Other& other) const {
-        auto r = range(other, base_type::size());
+        auto&& r = range(other, base_type::size());
         if (base_type::size() != r.size()) {
             return false;
         }
@@ -273,8 +316,8 @@ protected:
     template <typename Other, typename Func>
     vec_type& transform(const Other& other, Func func) {
         typename base_type::iterator i = base_type::begin();
-        auto r = range(other, base_type::size());
-        lm::transform(i, base_type::end(), r.begin(), r.end(), i, func);
+        auto&& r = range(other, base_type::size());
+        lm::transform_n(i, std::min<size_t>(base_type::size(), r.size()), r.begin(), i, func);
         return as_vec();
     }
 
@@ -0,0 +1,103 @@
+#include <catch.hpp>
+
+#include <cstdint>
+
+#include <lm/matrix/matrix.h>
+
+using namespace lm;
+
+namespace {
+
+vector_matrix<double> make_matrix(size_t n) {
+    vector_matrix<double> m(n, n);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            m(i, j) = static_cast<double>((i * 5 + j * 3) % 7) + (i == j ? 10 : 0);
+        }
+    }
+    return m;
+}
+
+}
+
+TEST_CASE("arena allocations are aligned", "[arena]") {
+    arena a(256);
+    a.allocate(1, 1);
+    void* p = a.allocate(64, 32);
+    REQUIRE( reinterpret_cast<uintptr_t>(p) % 32 == 0 );
+
+    void* big = a.allocate(1024, 16);
+    REQUIRE( big != nullptr );
+    REQUIRE( reinterpret_cast<uintptr_t>(big) % 16 == 0 );
+}
+
+TEST_CASE("arena reuses blocks after reset", "[arena]") {
+    arena a(1024);
+    const vector_matrix<double> m = make_matrix(12);
+
+    m.determinant(a);
+    a.reset();
+    const size_t capacity = a.capacity();
+    REQUIRE( capacity > 0 );
+
+    for (int i = 0; i < 10; i++) {
+        m.determinant(a);
+        a.reset();
+    }
+    REQUIRE( a.capacity() == capacity );
+
+    a.release();
+    REQUIRE( a.capacity() == 0 );
+}
+
+TEST_CASE("arena_scope restores previous arena", "[arena]") {
+    arena a, b;
+    REQUIRE( current_arena() == nullptr );
+    {
+        arena_scope sa(a);
+        REQUIRE( current_arena() == &a );
+        {
+            arena_scope sb(b);
+            REQUIRE( current_arena() == &b );
+        }
+        REQUIRE( current_arena() == &a );
+    }
+    REQUIRE( current_arena() == nullptr );
+}
+
+TEST_CASE("algorithms with arena give same results", "[arena]") {
+    arena a;
+    const vector_matrix<double> m = make_matrix(6);
+
+    REQUIRE( m.determinant(a) == Approx(m.determinant()) );
+
+    vector_matrix<double> inv = m, inv_arena = m;
+    REQUIRE( inv.invert() );
+    REQUIRE( inv_arena.invert(a) );
+    REQUIRE( inv_arena == inv );
+
+    vector_matrix<double> t = m, t_arena = m;
+    t.transpose();
+    t_arena.transpose(a);
+    REQUIRE( t_arena == t );
+
+    vector_matrix<double> p = m, p_arena = m;
+    p.post_product(m);
+    p_arena.post_product(m, a);
+    REQUIRE( p_arena == p );
+
+    p.pre_product(inv);
+    p_arena.pre_product(inv, a);
+    REQUIRE( p_arena == p );
+
+    REQUIRE( current_arena() == nullptr );
+}
+
+TEST_CASE("arena overloads for static matricies", "[arena]") {
+    arena a;
+    array_matrix<double, 2, 2> m = {1., 2., 3., 4.};
+    REQUIRE( m.determinant(a) == Approx(-2.) );
+    REQUIRE( m.invert(a) );
+    REQUIRE( m(0, 0) == Approx(-2.) );
+    REQUIRE( a.capacity() == 0 );
+}
@@ -0,0 +1,80 @@
+#include <catch.hpp>
+
+#include <lm/matrix/matrix.h>
+
+using namespace lm;
+
+namespace {
+
+template <typename M>
+M make_matrix(size_t n, size_t seed) {
+    M m(n, n);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            m(i, j) = static_cast<double>((i * 5 + j * 3 + seed) % 7) + (i == j ? 10 : 0);
+        }
+    }
+    return m;
+}
+
+}
+
+TEST_CASE("size_dispatch", "[dispatch]") {
+    size_t called = 0;
+    REQUIRE( size_dispatch<>::call(5, [&](auto s) { called = decltype(s)::value; }) );
+    REQUIRE( called == 5 );
+
+    REQUIRE( !size_dispatch<>::call(1, [&](auto s) { called = decltype(s)::value; }) );
+    REQUIRE( !size_dispatch<>::call(9, [&](auto s) { called = decltype(s)::value; }) );
+    REQUIRE( called == 5 );
+}
+
+TEST_CASE("fixed_view references flat data", "[dispatch]") {
+    double data[6] = {1., 2., 3., 4., 5., 6.};
+
+    auto rm = fixed_view<2, 3, row_major_layout>(data);
+    REQUIRE( rm(1, 0) == 4. );
+
+    auto cm = fixed_view<2, 3, col_major_layout>(data);
+    REQUIRE( cm(1, 0) == 2. );
+
+    cm(0, 1) = 10.;
+    REQUIRE( data[2] == 10. );
+}
+
+TEST_CASE("dispatched algorithms match generic ones", "[dispatch]") {
+    for (size_t n = 1; n <= fixed_size_max + 1; n++) {
+        const vector_matrix<double> a = make_matrix<vector_matrix<double>>(n, 1);
+        const vector_matrix<double, col_major_layout> b = make_matrix<vector_matrix<double, col_major_layout>>(n, 2);
+
+        vector_matrix<double> p;
+        product(a, b, p);
+        for (size_t i = 0; i < n; i++) {
+            for (size_t j = 0; j < n; j++) {
+                double sum = 0;
+                for (size_t k = 0; k < n; k++) {
+                    sum += a(i, k) * b(k, j);
+                }
+                REQUIRE( p(i, j) == sum );
+            }
+        }
+
+        REQUIRE( determinant(a) == Approx(determinant_using<vector_matrix<double>>(a)) );
+
+        vector_matrix<double> inv, generic_inv;
+        REQUIRE( invert_matrix(a, inv) );
+        REQUIRE( invert_matrix_using<vector_matrix<double>>(a, generic_inv) );
+        for (size_t i = 0; i < n; i++) {
+            for (size_t j = 0; j < n; j++) {
+                REQUIRE( inv(i, j) == Approx(generic_inv(i, j)) );
+            }
+        }
+    }
+}
+
+TEST_CASE("dispatch skips non-square matricies", "[dispatch]") {
+    vector_matrix<double> a = {{1., 2., 3.}, {4., 5., 6.}};
+    vector_matrix<double> b = {{1., 0.}, {0., 1.}, {1., 1.}};
+    vector_matrix<double> p = a * b;
+    REQUIRE( p == vector_matrix<double>({{4., 5.}, {10., 11.}}) );
+}
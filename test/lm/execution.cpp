@@ -0,0 +1,136 @@
+#include <catch.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include <lm/matrix/matrix.h>
+#include <lm/util/execution.h>
+
+using namespace lm;
+
+namespace {
+
+const execution_policy par4 = execution::par.with_threads(4).with_grain(1);
+
+vector_matrix<double> make_matrix(size_t rows, size_t cols, size_t seed) {
+    vector_matrix<double> m(rows, cols);
+    for (size_t i = 0; i < rows; i++) {
+        for (size_t j = 0; j < cols; j++) {
+            m(i, j) = static_cast<double>((i * 7 + j * 3 + seed) % 11) - 5. + (i == j ? 20. : 0.);
+        }
+    }
+    return m;
+}
+
+}
+
+TEST_CASE("parallel_for covers range once", "[execution]") {
+
+    // Catch assertions aren't thread-safe, so results of workers are checked after join
+    std::vector<std::atomic<int>> visits(100);
+    for (auto& v : visits) {
+        v = 0;
+    }
+    std::atomic<int> outside_region(0);
+    parallel_for(par4, 0, visits.size(), [&](size_t begin, size_t end) {
+        if (!in_parallel_region()) {
+            outside_region++;
+        }
+        for (size_t i = begin; i < end; i++) {
+            visits[i]++;
+        }
+    });
+    for (auto& v : visits) {
+        REQUIRE( v == 1 );
+    }
+    REQUIRE( outside_region == 0 );
+    REQUIRE( !in_parallel_region() );
+
+    size_t calls = 0;
+    parallel_for(execution::seq, 0, 100, [&](size_t begin, size_t end) {
+        REQUIRE( begin == 0 );
+        REQUIRE( end == 100 );
+        calls++;
+    });
+    REQUIRE( calls == 1 );
+
+    // range smaller than grain isn't split
+    std::atomic<size_t> chunks(0), longest(0);
+    parallel_for(execution::par.with_threads(4).with_grain(64), 0, 100, [&](size_t begin, size_t end) {
+        chunks++;
+        longest = end - begin;
+    });
+    REQUIRE( chunks == 1 );
+    REQUIRE( longest == 100 );
+
+}
+
+TEST_CASE("parallel_for rethrows exception of worker", "[execution]") {
+    REQUIRE_THROWS_AS( parallel_for(par4, 0, 8, [](size_t begin, size_t) {
+        if (begin != 0) {
+            throw std::runtime_error("worker");
+        }
+    }), std::runtime_error );
+}
+
+TEST_CASE("execution_policy thread_count", "[execution]") {
+    REQUIRE( execution::seq.thread_count() == 1 );
+    REQUIRE( execution::simd.thread_count() == 1 );
+    REQUIRE( execution::par.with_threads(3).thread_count() == 3 );
+    REQUIRE( execution::par_simd.thread_count() >= 1 );
+}
+
+TEST_CASE("parallel algorithms give same results as sequential ones", "[execution]") {
+
+    typedef vector_matrix<double, col_major_layout> col;
+
+    const vector_matrix<double> a = make_matrix(37, 37, 1), b = make_matrix(37, 23, 2);
+
+    vector_matrix<double> p1, p2;
+    product(a, b, p1);
+    product(par4, a, b, p2);
+    REQUIRE( p1 == p2 );
+
+    col c1, c2;
+    product(col(a), col(b), c1);
+    product(par4, col(a), col(b), c2);
+    REQUIRE( c1 == c2 );
+
+    product(transposed(a), b, p1);
+    product(par4, transposed(a), b, p2);
+    REQUIRE( p1 == p2 );
+
+    vector_matrix<double> t1, t2;
+    transpose(b, t1);
+    transpose(par4, b, t2);
+    REQUIRE( t1 == t2 );
+
+    pivoted_matrix<vector_matrix<double>> lu1(a), lu2(a);
+    REQUIRE( lu_decomposition(lu1) );
+    REQUIRE( lu_decomposition(par4, lu2) );
+    REQUIRE( lu1 == lu2 );
+
+    vector_matrix<double> x1(b), x2(b);
+    REQUIRE( lu_substitute(lu1, x1) );
+    REQUIRE( lu_substitute(par4, lu2, x2) );
+    REQUIRE( x1 == x2 );
+
+    vector_matrix<double> i1, i2;
+    REQUIRE( invert_matrix(a, i1) );
+    REQUIRE( invert_matrix(execution::par_simd.with_threads(4).with_grain(1), a, i2) );
+    REQUIRE( i1 == i2 );
+
+    vector_matrix<double> e(5, 5);
+    make_identity(par4, e);
+    REQUIRE( e == (vector_matrix<double>{{1., 0., 0., 0., 0.}, {0., 1., 0., 0., 0.}, {0., 0., 1., 0., 0.},
+                                          {0., 0., 0., 1., 0.}, {0., 0., 0., 0., 1.}}) );
+
+    vector_matrix<double> s1(a), s2(a);
+    const vector_matrix<double> d = make_matrix(37, 37, 3);
+    s1.apply(d, [](double x, double y) { return x * 2 - y; });
+    s2.apply(par4, d, [](double x, double y) { return x * 2 - y; });
+    REQUIRE( s1 == s2 );
+
+}
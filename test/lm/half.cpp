@@ -0,0 +1,135 @@
+#include <catch.hpp>
+
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <vector>
+
+#include <lm/util/half.h>
+#include <lm/matrix/io.h>
+#include <lm/matrix/text.h>
+#include <lm/matrix/widening.h>
+
+using namespace lm;
+
+TEST_CASE("half conversion", "[half]") {
+    REQUIRE( half(1.f).bits() == 0x3c00 );
+    REQUIRE( half(-2.f).bits() == 0xc000 );
+    REQUIRE( half(65504.f).bits() == 0x7bff );
+    REQUIRE( half(65520.f).bits() == 0x7c00 );
+    REQUIRE( half(std::ldexp(1.f, -24)).bits() == 0x0001 );
+    REQUIRE( half(std::ldexp(1.f, -26)).bits() == 0x0000 );
+    REQUIRE( std::isnan(static_cast<float>(half(std::numeric_limits<float>::quiet_NaN()))) );
+
+    // ties are rounded to even
+    REQUIRE( half(1.f + std::ldexp(1.f, -11)).bits() == 0x3c00 );
+    REQUIRE( half(1.f + 3 * std::ldexp(1.f, -11)).bits() == 0x3c02 );
+
+    REQUIRE( static_cast<float>(half::from_bits(0x3555)) == Approx(0.333252f) );
+}
+
+TEST_CASE("bfloat16 conversion", "[half]") {
+    REQUIRE( bfloat16(1.f).bits() == 0x3f80 );
+    REQUIRE( bfloat16(-1.f).bits() == 0xbf80 );
+    REQUIRE( bfloat16(1.f + std::ldexp(1.f, -8)).bits() == 0x3f80 );
+    REQUIRE( bfloat16(1.f + 3 * std::ldexp(1.f, -8)).bits() == 0x3f82 );
+    REQUIRE( static_cast<float>(bfloat16(3.f)) == 3.f );
+    REQUIRE( std::isnan(static_cast<float>(bfloat16(std::numeric_limits<float>::quiet_NaN()))) );
+}
+
+TEST_CASE("bulk conversion matches scalar conversion", "[half]") {
+    std::vector<half> h(1 << 16);
+    for (size_t i = 0; i < h.size(); i++) {
+        h[i] = half::from_bits(static_cast<uint16_t>(i));
+    }
+
+    std::vector<float> f(h.size());
+    convert_elements(h.data(), f.data(), h.size());
+
+    std::vector<half> back(h.size());
+    convert_elements(f.data(), back.data(), f.size());
+
+    for (size_t i = 0; i < h.size(); i++) {
+        if (std::isnan(f[i])) {
+            REQUIRE( std::isnan(static_cast<float>(back[i])) );
+            continue;
+        }
+        REQUIRE( f[i] == half_bits_to_float(static_cast<uint16_t>(i)) );
+        REQUIRE( back[i].bits() == i );
+    }
+
+    std::vector<bfloat16> b(100);
+    std::vector<float> bf(b.size());
+    for (size_t i = 0; i < b.size(); i++) {
+        b[i] = static_cast<float>(i) * 0.25f - 3.f;
+    }
+    convert_elements(b.data(), bf.data(), b.size());
+    for (size_t i = 0; i < b.size(); i++) {
+        REQUIRE( bf[i] == static_cast<float>(i) * 0.25f - 3.f );
+    }
+}
+
+TEST_CASE("half matricies", "[half]") {
+    vector_matrix<half> m = {
+        { 2., 1. },
+        { 1., 3. }
+    };
+    REQUIRE( static_cast<float>(m.determinant()) == 5.f );
+
+    REQUIRE( m.invert() );
+    REQUIRE( static_cast<float>(m(0, 0)) == Approx(0.6f).epsilon(1e-3) );
+
+    array_matrix<bfloat16, 2, 2> b = {1., 2., 3., 4.};
+    b += b;
+    REQUIRE( static_cast<float>(b(1, 1)) == 8.f );
+}
+
+TEST_CASE("half matrix file and text roundtrip", "[half]") {
+    vector_matrix<half> m = {{0.5, -1.25}, {1024., 3.}};
+
+    std::stringstream binary;
+    save(binary, m);
+    vector_matrix<half> loaded;
+    load(binary, loaded);
+    REQUIRE( loaded.value()[1].bits() == m.value()[1].bits() );
+
+    std::stringstream text;
+    write_text(text, m);
+    vector_matrix<bfloat16> parsed;
+    read_text(text, parsed);
+    REQUIRE( static_cast<float>(parsed(0, 1)) == -1.25f );
+    REQUIRE( static_cast<float>(parsed(1, 0)) == 1024.f );
+}
+
+TEST_CASE("widening_product", "[half]") {
+    const size_t rows = 37, inner = 70, cols = 67;
+    vector_matrix<half> a(rows, inner);
+    vector_matrix<bfloat16, col_major_layout> b(inner, cols);
+    for (size_t i = 0; i < rows; i++) {
+        for (size_t k = 0; k < inner; k++) {
+            a(i, k) = static_cast<float>((i * 3 + k) % 9) * 0.125f - 0.5f;
+        }
+    }
+    for (size_t k = 0; k < inner; k++) {
+        for (size_t j = 0; j < cols; j++) {
+            b(k, j) = static_cast<float>((k + j * 5) % 7) * 0.5f - 1.f;
+        }
+    }
+
+    vector_matrix<float> r;
+    widening_product(a, b, r);
+
+    vector_matrix<half> hr;
+    widening_product<float, 16>(a, b, hr);
+
+    for (size_t i = 0; i < rows; i++) {
+        for (size_t j = 0; j < cols; j++) {
+            double sum = 0;
+            for (size_t k = 0; k < inner; k++) {
+                sum += static_cast<float>(a(i, k)) * static_cast<float>(b(k, j));
+            }
+            REQUIRE( r(i, j) == Approx(sum) );
+            REQUIRE( static_cast<float>(hr(i, j)) == static_cast<float>(half(sum)) );
+        }
+    }
+}
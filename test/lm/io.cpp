@@ -0,0 +1,128 @@
+#include <catch.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <sstream>
+#include <string>
+
+#include <lm/matrix/io.h>
+#include <lm/vec/vec.h>
+
+using namespace lm;
+
+TEST_CASE("save and load flat matricies", "[io]") {
+
+    array_matrix<float, 2, 3> a = {1,2,3,4,5,6};
+
+    std::stringstream ss;
+    save(ss, a);
+    REQUIRE( ss.str().size() == 64 + 6 * sizeof(float) );
+
+    array_matrix<float, 2, 3> b;
+    load(ss, b);
+    REQUIRE( a == b );
+
+    ss.seekg(0);
+    vector_matrix<float, col_major_layout> c;
+    load(ss, c);
+    REQUIRE( c.rows() == 2 );
+    REQUIRE( c.cols() == 3 );
+    REQUIRE( c == a );
+
+    std::stringstream ss2;
+    save(ss2, c);
+    flat_array_matrix<float, 2, 3> d;
+    load(ss2, d);
+    REQUIRE( d == a );
+
+    ss2.seekg(0);
+    container_matrix<vec, float, 2, 3> e;
+    load(ss2, e);
+    REQUIRE( e == a );
+
+}
+
+TEST_CASE("save non-flat matrix", "[io]") {
+
+    vector_matrix<double> v = {{1,2,3},{4,5,6}};
+    transpose_matrix<vector_matrix<double>&> t(v);
+
+    std::stringstream ss;
+    save(ss, t);
+
+    vector_matrix<double> r;
+    load(ss, r);
+    REQUIRE( r.rows() == 3 );
+    REQUIRE( r == t );
+
+}
+
+TEST_CASE("load validates header", "[io]") {
+
+    array_matrix<float, 2, 2> a = {1,2,3,4};
+    std::stringstream ss;
+    save(ss, a);
+
+    vector_matrix<double> d;
+    REQUIRE_THROWS_AS( load(ss, d), std::runtime_error );
+
+    ss.seekg(0);
+    array_matrix<float, 3, 3> s;
+    REQUIRE_THROWS_AS( load(ss, s), std::runtime_error );
+
+    std::stringstream garbage("not a matrix file at all, definitely not a matrix file at all, really");
+    REQUIRE_THROWS_AS( load(garbage, d), std::runtime_error );
+
+}
+
+TEST_CASE("header with overflowing size or unknown layout is invalid", "[io]") {
+
+    const matrix_file_header valid = matrix_file_header::make<float, row_major_layout>(4, 4);
+    REQUIRE( valid.is_valid(valid.file_size()) );
+    REQUIRE( !valid.is_valid(valid.file_size() - 1) );
+
+    // rows * cols * sizeof(float) wraps around to 4 bytes
+    matrix_file_header h = valid;
+    h.rows = uint64_t(1) << 62;
+    h.cols = 4;
+    REQUIRE( !h.is_valid(valid.file_size()) );
+    REQUIRE( !h.is_valid(std::numeric_limits<size_t>::max()) );
+
+    std::stringstream ss;
+    ss.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    ss << std::string(64, '\0');
+    vector_matrix<float> m;
+    REQUIRE_THROWS_AS( load(ss, m), std::runtime_error );
+
+    h = valid;
+    h.layout = 2;
+    REQUIRE( !h.is_valid(valid.file_size()) );
+
+    h = valid;
+    h.data_offset = 0;
+    h.alignment = 1;
+    REQUIRE( !h.is_valid(valid.file_size()) );
+
+    h = valid;
+    h.data_offset = valid.file_size() + 64;
+    h.rows = 0;
+    REQUIRE( !h.is_valid(valid.file_size()) );
+
+}
+
+TEST_CASE("load_view maps saved file", "[io]") {
+
+    const std::string path = "lm_io_view.bin";
+    vector_matrix<int32_t> v = {{1,2,3},{4,5,6}};
+    save(path, v);
+
+    {
+        mmap_matrix<int32_t> m = load_view<int32_t>(path);
+        REQUIRE( m == v );
+        REQUIRE( reinterpret_cast<uintptr_t>(m.data()) % 64 == 0 );
+    }
+
+    std::remove(path.c_str());
+
+}
@@ -1,5 +1,8 @@
 #include <catch.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
 #include <vector>
 
 #include <lm/matrix/matrix.h>
@@ -272,7 +275,8 @@ TEST_CASE("determinant", "[matrix]") {
     for (size_t i = 0; i < sizeof(expected_det) / sizeof(float); i++) {
         array_matrix<float, 3, 3> m(test_matricies[i]);
         float det = determinant(m);
-        REQUIRE( det == expected_det[i] );
+        // partial pivoting divides by largest elements, so multipliers aren't exact
+        REQUIRE( det == Approx(expected_det[i]).margin(1e-5) );
     }
 
 }
@@ -330,13 +334,14 @@ TEST_CASE("invert", "[matrix]") {
 
 }
 
+// singular matricies which elimination with partial pivoting reduces to exact zero pivot
 TEST_CASE("lu_decomposition must return false if singular", "[matrix]") {
-    array_matrix<float, 3, 3> m = {1,2,3,4,5,6,7,8,9};
+    array_matrix<float, 3, 3> m = {1,2,3,2,4,6,1,1,1};
     REQUIRE_FALSE(lu_decomposition(m));
 }
 
 TEST_CASE("invert fails if singular", "[matrix]") {
-    array_matrix<float, 3, 3> m = {1,2,3,4,5,6,7,8,9};
+    array_matrix<float, 3, 3> m = {1,2,3,2,4,6,1,1,1};
     array_matrix<float, 3, 3> inv;
     REQUIRE_FALSE( invert_matrix(m, inv) );
 }
@@ -392,3 +397,525 @@ TEST_CASE("homogenuous_product", "[matrix]") {
 }
 
 
+
+TEST_CASE("invert keeps reference matrix unchanged", "[matrix]") {
+
+    float a[3][3] = {{9,1,2},{3,4,5},{6,7,8}};
+    array_matrix<float, 3, 3>::reference_matrix_type m(a);
+    array_matrix<float, 3, 3> inv;
+    REQUIRE( invert_matrix(m, inv) );
+    REQUIRE( determinant(m) == Approx(-27.f) );
+    REQUIRE( m == (array_matrix<float, 3, 3>({9,1,2,3,4,5,6,7,8})) );
+
+    vector_matrix<float> v = {{1,2},{3,4},{5,6}};
+    transpose_matrix<vector_matrix<float>&> t(v);
+    transpose_matrix<vector_matrix<float>> c(t);
+    REQUIRE( c == t );
+
+}
+
+namespace {
+
+size_t allocation_count = 0;
+
+template <typename T>
+struct counting_allocator: public std::allocator<T> {
+    template <typename U> struct rebind { typedef counting_allocator<U> other; };
+
+    counting_allocator() = default;
+    template <typename U> counting_allocator(const counting_allocator<U>&) {}
+
+    T* allocate(size_t n) {
+        ++allocation_count;
+        return std::allocator<T>::allocate(n);
+    }
+};
+
+typedef flat_dynamic_matrix<std::vector<double, counting_allocator<double>>> counting_matrix;
+
+}
+
+TEST_CASE("rvalue arithmetic reuses buffer", "[matrix]") {
+
+    counting_matrix a = {{1., 2.}, {3., 4.}};
+    counting_matrix b = {{5., 6.}, {7., 8.}};
+    counting_matrix c = {{1., 1.}, {1., 1.}};
+
+    allocation_count = 0;
+    counting_matrix s = (a + b) + c - c + c;
+    REQUIRE( allocation_count == 1 );
+    REQUIRE( s == counting_matrix({{7., 9.}, {11., 13.}}) );
+
+    allocation_count = 0;
+    counting_matrix m = std::move(s) + a;
+    REQUIRE( allocation_count == 0 );
+    REQUIRE( m == counting_matrix({{8., 11.}, {14., 17.}}) );
+    REQUIRE( s.rows() == 0 );
+    REQUIRE( s.cols() == 0 );
+
+    // decorators take over buffer of matrix
+    allocation_count = 0;
+    transpose_matrix<counting_matrix> t(std::move(m));
+    permutation_matrix<counting_matrix> p(std::move(t.value()));
+    REQUIRE( allocation_count == 0 );
+    REQUIRE( p(1, 0) == 14. );
+
+}
+
+TEST_CASE("flat_dynamic_storage adopts container", "[matrix]") {
+
+    std::vector<double> v = {1., 2., 3., 4., 5., 6.};
+    const double* data = v.data();
+
+    vector_matrix<double> m(std::move(v), 2, 3);
+    REQUIRE( m.value().data() == data );
+    REQUIRE( m(1, 0) == 4. );
+
+}
+
+TEST_CASE("product_accumulate with wider accumulator", "[matrix]") {
+
+    vector_matrix<float> m = {{1e8f, 1.f, -1e8f}};
+    vector_matrix<float> n = {{1.f}, {1.f}, {1.f}};
+
+    vector_matrix<float> r;
+    product(m, n, r);
+    REQUIRE( r(0, 0) == 0.f );
+
+    product_accumulate<double>(m, n, r);
+    REQUIRE( r(0, 0) == 1.f );
+
+    vec<float, 3> v = {1e8f, 1.f, -1e8f};
+    REQUIRE( v.scalar_product<double>(vec<float, 3>({1.f, 1.f, 1.f})) == 1. );
+
+}
+
+TEST_CASE("solve with multiple right-hand sides", "[matrix]") {
+
+    vector_matrix<double> a = {{2., 1., 1.}, {1., 3., 2.}, {1., 0., 0.}};
+    vector_matrix<double> b = {{4., 5.}, {5., 6.}, {6., 7.}};
+
+    vector_matrix<double> x;
+    REQUIRE( solve(a, b, x) );
+    REQUIRE( x.rows() == 3 );
+    REQUIRE( x.cols() == 2 );
+
+    vector_matrix<double> ax = a * x;
+    for (size_t i = 0; i < b.rows(); i++) {
+        for (size_t j = 0; j < b.cols(); j++) {
+            REQUIRE( ax(i, j) == Approx(b(i, j)) );
+        }
+    }
+
+}
+
+TEST_CASE("solve_refined improves accuracy of float factorization", "[matrix]") {
+
+    const size_t n = 5;
+    vector_matrix<float> a(n, n);
+    vector_matrix<double> b(n, 1);
+    for (size_t i = 0; i < n; i++) {
+        double sum = 0;
+        for (size_t j = 0; j < n; j++) {
+            a(i, j) = 1.f / static_cast<float>(i + j + 1);
+            sum += a(i, j);
+        }
+        b(i, 0) = sum;
+    }
+
+    vector_matrix<double> x, refined;
+    REQUIRE( solve(a, b, x) );
+    REQUIRE( solve_refined<double>(a, b, refined, 20) );
+
+    double error = 0, refined_error = 0;
+    for (size_t i = 0; i < n; i++) {
+        error = std::max(error, std::abs(x(i, 0) - 1.));
+        refined_error = std::max(refined_error, std::abs(refined(i, 0) - 1.));
+    }
+    REQUIRE( refined_error < 1e-9 );
+    REQUIRE( refined_error < error );
+
+}
+
+TEST_CASE("matrix_layout sees through decorators", "[matrix]") {
+
+    typedef vector_matrix<double, col_major_layout> col_matrix;
+    REQUIRE( !is_col_major<vector_matrix<double>>::value );
+    REQUIRE( is_col_major<col_matrix>::value );
+    REQUIRE( is_col_major<transpose_matrix<vector_matrix<double>>>::value );
+    REQUIRE( !is_col_major<transpose_matrix<col_matrix>>::value );
+    REQUIRE( is_col_major<permutation_matrix<col_matrix>>::value );
+    REQUIRE( is_col_major<flat_array_matrix<double, 2, 2, col_major_layout>>::value );
+    REQUIRE( !is_col_major<array_matrix<double, 2, 2>>::value );
+
+    REQUIRE( (product_loop_order<vector_matrix<double>, vector_matrix<double>, vector_matrix<double>>::value == product_order::ikj) );
+    REQUIRE( (product_loop_order<col_matrix, col_matrix, col_matrix>::value == product_order::jki) );
+    REQUIRE( (product_loop_order<vector_matrix<double>, col_matrix, vector_matrix<double>>::value == product_order::ijk) );
+    REQUIRE( (product_loop_order<col_matrix, vector_matrix<double>, vector_matrix<double>>::value == product_order::kij) );
+    REQUIRE( (product_loop_order<vector_matrix<double>, col_matrix, col_matrix>::value == product_order::ijk) );
+
+}
+
+namespace {
+
+template <typename M, typename N, typename P>
+void check_product_layouts(const vector_matrix<double>& a, const vector_matrix<double>& b, const vector_matrix<double>& expected) {
+    M m;
+    N n;
+    m.assign(a);
+    n.assign(b);
+    P p;
+    product(m, n, p);
+    REQUIRE( p.rows() == expected.rows() );
+    REQUIRE( p.cols() == expected.cols() );
+    for (size_t i = 0; i < p.rows(); i++) {
+        for (size_t j = 0; j < p.cols(); j++) {
+            REQUIRE( p(i, j) == expected(i, j) );
+        }
+    }
+}
+
+}
+
+TEST_CASE("product gives same result for any layouts", "[matrix]") {
+
+    typedef vector_matrix<double> row;
+    typedef vector_matrix<double, col_major_layout> col;
+
+    vector_matrix<double> a(4, 3), b(3, 5), expected(4, 5);
+    for (size_t i = 0; i < a.rows(); i++) {
+        for (size_t j = 0; j < a.cols(); j++) {
+            a(i, j) = 0.1 * static_cast<double>(i * 3 + j) - 0.7;
+        }
+    }
+    for (size_t i = 0; i < b.rows(); i++) {
+        for (size_t j = 0; j < b.cols(); j++) {
+            b(i, j) = 0.3 * static_cast<double>(i + j * 2) + 0.1;
+        }
+    }
+    for (size_t i = 0; i < expected.rows(); i++) {
+        for (size_t j = 0; j < expected.cols(); j++) {
+            double sum = 0;
+            for (size_t k = 0; k < a.cols(); k++) {
+                sum += a(i, k) * b(k, j);
+            }
+            expected(i, j) = sum;
+        }
+    }
+
+    check_product_layouts<row, row, row>(a, b, expected);
+    check_product_layouts<row, row, col>(a, b, expected);
+    check_product_layouts<row, col, row>(a, b, expected);
+    check_product_layouts<row, col, col>(a, b, expected);
+    check_product_layouts<col, row, row>(a, b, expected);
+    check_product_layouts<col, row, col>(a, b, expected);
+    check_product_layouts<col, col, row>(a, b, expected);
+    check_product_layouts<col, col, col>(a, b, expected);
+    check_product_layouts<transpose_matrix<row>, transpose_matrix<row>, transpose_matrix<row>>(a, b, expected);
+
+}
+
+TEST_CASE("lu_substitute gives same result for any layouts", "[matrix]") {
+
+    typedef vector_matrix<double> row;
+    typedef vector_matrix<double, col_major_layout> col;
+
+    const row a = {{4., 1., 2.}, {1., 5., 1.}, {2., 1., 6.}};
+    const row b = {{1., 2.}, {3., 4.}, {5., 6.}};
+
+    row expected;
+    REQUIRE( solve(a, b, expected) );
+
+    permutation_matrix<row> lu_row(a);
+    permutation_matrix<col> lu_col(a);
+    REQUIRE( lu_decomposition(lu_row) );
+    REQUIRE( lu_decomposition(lu_col) );
+
+    row x1;
+    col x2, x3;
+    REQUIRE( lu_solve(lu_col, b, x1) );
+    REQUIRE( lu_solve(lu_col, b, x2) );
+    REQUIRE( lu_solve(lu_row, b, x3) );
+    for (size_t i = 0; i < b.rows(); i++) {
+        for (size_t j = 0; j < b.cols(); j++) {
+            REQUIRE( x1(i, j) == expected(i, j) );
+            REQUIRE( x2(i, j) == expected(i, j) );
+            REQUIRE( x3(i, j) == expected(i, j) );
+        }
+    }
+
+}
+
+TEST_CASE("nested decorators are collapsed", "[matrix]") {
+
+    typedef vector_matrix<double> row;
+    REQUIRE( (std::is_same<permutation_matrix<permutation_matrix<row>>, permutation_matrix<row>>::value) );
+    REQUIRE( (std::is_same<permutation_matrix<permutation_matrix<permutation_matrix<row>>>, permutation_matrix<row>>::value) );
+
+    // transpose_matrix of transposed matrix transposes it again
+    transpose_matrix<row> t = {{1., 2.}, {3., 4.}};
+    REQUIRE( t(0, 1) == 3. );
+    transpose_matrix<transpose_matrix<row>> tt(t);
+    REQUIRE( tt(0, 1) == 2. );
+    REQUIRE( tt(1, 0) == 3. );
+
+    // while its value is the value of matrix itself
+    REQUIRE( (std::is_same<transpose_matrix<transpose_matrix<row>>::value_matrix_type, row>::value) );
+    row v = tt;
+    REQUIRE( v == tt );
+
+    // and transposed view of transposed view refers to the matrix itself
+    row a = {{1., 2.}, {3., 4.}};
+    REQUIRE( &transposed(transposed(a)) == &a );
+    auto view = transposed(a);
+    REQUIRE( &transposed(view) == &a );
+
+    permutation_matrix<permutation_matrix<row>> p = {{1., 2.}, {3., 4.}};
+    p.swap_row(0, 1);
+    REQUIRE( p(0, 0) == 3. );
+    REQUIRE( p.permutation_count() == 1 );
+
+}
+
+TEST_CASE("transposed flat matrix is flat with flipped layout", "[matrix]") {
+
+    typedef flat_traits<transpose_matrix<vector_matrix<double>>> traits;
+    REQUIRE( traits::is_flat );
+    REQUIRE( (std::is_same<traits::layout_type, col_major_layout>::value) );
+    REQUIRE( (is_row_major_flat<transpose_matrix<vector_matrix<double, col_major_layout>>>::value) );
+
+    vector_matrix<double> v = {{1., 2., 3.}, {4., 5., 6.}};
+    transpose_matrix<vector_matrix<double>> t(v);
+    REQUIRE( traits::data(t) == t.value().value().data() );
+    REQUIRE( t(2, 1) == 6. );
+
+    // value of transposed matrix is flat matrix with flipped layout which keeps elements in same order
+    typedef transpose_matrix<vector_matrix<double>>::value_matrix_type value_type;
+    REQUIRE( (std::is_same<value_type, vector_matrix<double, col_major_layout>>::value) );
+    REQUIRE( (std::is_same<transpose_matrix<vector_matrix<double>&>::value_matrix_type, value_type>::value) );
+    const value_type c = t;
+    REQUIRE( c == t );
+    REQUIRE( std::equal(v.value().begin(), v.value().end(), c.value().begin()) );
+    const vector_matrix<double> s = t + t;
+    REQUIRE( s(2, 1) == 12. );
+
+}
+
+TEST_CASE("product of transposed views", "[matrix]") {
+
+    vector_matrix<double> a(3, 4), b(3, 5), c(5, 4);
+    for (size_t i = 0; i < a.rows(); i++) {
+        for (size_t j = 0; j < a.cols(); j++) {
+            a(i, j) = 0.25 * static_cast<double>(i * 4 + j) - 1.;
+        }
+    }
+    for (size_t i = 0; i < b.rows(); i++) {
+        for (size_t j = 0; j < b.cols(); j++) {
+            b(i, j) = 0.5 * static_cast<double>(i + j * 3) + 0.125;
+        }
+    }
+    for (size_t i = 0; i < c.rows(); i++) {
+        for (size_t j = 0; j < c.cols(); j++) {
+            c(i, j) = 0.75 * static_cast<double>(i * 2 + j) - 0.5;
+        }
+    }
+
+    const vector_matrix<double> at = a.compute_transposed(), bt = b.compute_transposed(), ct = c.compute_transposed();
+    REQUIRE( (product_loop_order<decltype(transposed(a)), vector_matrix<double>, vector_matrix<double>>::value == product_order::kij) );
+
+    vector_matrix<double> tn, expected_tn;
+    product(transposed(a), b, tn);
+    product(at, b, expected_tn);
+    REQUIRE( tn == expected_tn );
+
+    vector_matrix<double> nt, expected_nt;
+    product(b, transposed(ct), nt);
+    product(b, c, expected_nt);
+    REQUIRE( nt.rows() == 3 );
+    REQUIRE( nt.cols() == 4 );
+    REQUIRE( nt == expected_nt );
+
+    vector_matrix<double> tt, expected_tt;
+    product(transposed(bt), transposed(ct), tt);
+    product(b, c, expected_tt);
+    REQUIRE( tt == expected_tt );
+
+    // view of const matrix is read-only even if it isn't const itself
+    auto ct_view = transposed(ct);
+    REQUIRE( (std::is_same<decltype(ct_view(0, 0)), const double&>::value) );
+    REQUIRE( (flat_traits<decltype(ct_view)>::is_flat) );
+    REQUIRE( ct_view(1, 2) == ct(2, 1) );
+
+    // view refers to original matrix
+    transposed(a)(3, 2) = 42.;
+    REQUIRE( a(2, 3) == 42. );
+
+}
+
+TEST_CASE("pivoted LU-factorization matches permutation one", "[matrix]") {
+
+    typedef vector_matrix<double> row;
+    typedef vector_matrix<double, col_major_layout> col;
+
+    const row a = {{1., 5., 2., 3.}, {4., 1., 7., 2.}, {0., 3., 1., 6.}, {2., 2., 8., 1.}};
+
+    permutation_matrix<row> expected(a);
+    pivoted_matrix<row> lu_row(a);
+    pivoted_matrix<col> lu_col(a);
+    REQUIRE( lu_decomposition(expected) );
+    REQUIRE( lu_decomposition(lu_row) );
+    REQUIRE( lu_decomposition(lu_col) );
+
+    REQUIRE( expected.permutation_count() > 0 );
+    REQUIRE( lu_row.permutation_count() == expected.permutation_count() );
+    REQUIRE( lu_col.permutation_count() == expected.permutation_count() );
+    for (size_t i = 0; i < a.rows(); i++) {
+        REQUIRE( lu_row.permutation_vec()[i] == expected.permutation_vec()[i] );
+        REQUIRE( lu_col.permutation_vec()[i] == expected.permutation_vec()[i] );
+        for (size_t j = 0; j < a.cols(); j++) {
+            REQUIRE( lu_row(i, j) == expected(i, j) );
+            REQUIRE( lu_col(i, j) == expected(i, j) );
+            // factorization is stored in underlying matrix without indirection
+            REQUIRE( lu_row.value()(i, j) == expected(i, j) );
+        }
+    }
+
+    REQUIRE( (flat_traits<pivoted_matrix<row>>::is_flat) );
+    REQUIRE( is_col_major<pivoted_matrix<col>>::value );
+
+}
+
+TEST_CASE("swap_col swaps columns", "[matrix]") {
+
+    array_matrix<int, 2, 3> s = {{1, 2, 3}, {4, 5, 6}};
+    s.swap_col(0, 2);
+    REQUIRE( s == (array_matrix<int, 2, 3>{{3, 2, 1}, {6, 5, 4}}) );
+
+    vector_matrix<int> d = {{1, 2, 3}, {4, 5, 6}};
+    d.swap_col(0, 1);
+    REQUIRE( d == (vector_matrix<int>{{2, 1, 3}, {5, 4, 6}}) );
+
+    permutation_matrix<vector_matrix<int>> p = {{1, 2, 3}, {4, 5, 6}};
+    p.swap_row(0, 1);
+    p.swap_col(1, 2);
+    REQUIRE( p == (vector_matrix<int>{{4, 6, 5}, {1, 3, 2}}) );
+
+}
+
+TEST_CASE("inplace determinant, inverse and solve", "[matrix]") {
+
+    const vector_matrix<double> a = {{0., 2., 1., 4.}, {1., 1., 0., 2.}, {3., 0., 1., 1.}, {2., 5., 3., 0.}};
+    const vector_matrix<double> b = {{1., 2.}, {3., 4.}, {5., 6.}, {7., 8.}};
+
+    vector_matrix<double> m(a);
+    REQUIRE( determinant_inplace(m) == Approx(determinant(a)) );
+
+    m = a;
+    vector_matrix<double> expected_inv;
+    REQUIRE( invert_matrix(a, expected_inv) );
+    REQUIRE( invert_inplace(m) );
+    for (size_t i = 0; i < a.rows(); i++) {
+        for (size_t j = 0; j < a.cols(); j++) {
+            REQUIRE( m(i, j) == Approx(expected_inv(i, j)) );
+        }
+    }
+
+    m = a;
+    vector_matrix<double> x(b), expected_x;
+    REQUIRE( solve(a, b, expected_x) );
+    REQUIRE( solve_inplace(m, x) );
+    for (size_t i = 0; i < x.rows(); i++) {
+        for (size_t j = 0; j < x.cols(); j++) {
+            REQUIRE( x(i, j) == expected_x(i, j) );
+        }
+    }
+
+    vector_matrix<double> singular = {{1., 2.}, {2., 4.}};
+    REQUIRE( determinant_inplace(singular) == 0. );
+    singular = {{1., 2.}, {2., 4.}};
+    REQUIRE( !invert_inplace(singular) );
+
+    array_matrix<float, 3, 3> s = {{1.f, 2.f, 3.f}, {0.f, 1.f, 4.f}, {5.f, 6.f, 0.f}};
+    const array_matrix<float, 3, 3> s_inv = {{-24.f, 18.f, 5.f}, {20.f, -15.f, -4.f}, {-5.f, 4.f, 1.f}};
+    REQUIRE( invert_inplace(s) );
+    for (size_t i = 0; i < s.rows(); i++) {
+        for (size_t j = 0; j < s.cols(); j++) {
+            REQUIRE( s(i, j) == Approx(s_inv(i, j)).margin(1e-4) );
+        }
+    }
+
+}
+
+TEST_CASE("permute_rows applies permutation in place", "[matrix]") {
+
+    vector_matrix<int> m = {{0}, {1}, {2}, {3}, {4}, {5}};
+    const size_t p[] = {3, 0, 5, 1, 4, 2};
+    permute_rows(m, p);
+    REQUIRE( m == (vector_matrix<int>{{3}, {0}, {5}, {1}, {4}, {2}}) );
+
+}
+
+TEST_CASE("lu_decomposition with partial pivoting is stable for dense matricies", "[matrix]") {
+
+    const size_t n = 100;
+    vector_matrix<double> a(n, n);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            a(i, j) = static_cast<double>((i * 7 + j * 3) % 11) - 5. + (i == j ? 20. : 0.);
+        }
+    }
+
+    pivoted_matrix<vector_matrix<double>> lu(a);
+    REQUIRE( lu_decomposition(lu) );
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            // multipliers are at most 1 by magnitude
+            if (j < i) {
+                REQUIRE( std::abs(lu(i, j)) <= 1. );
+            }
+            double s = 0;
+            for (size_t k = 0; k <= std::min(i, j); k++) {
+                s += (k == i ? 1. : lu(i, k)) * lu(k, j);
+            }
+            REQUIRE( s == Approx(a(lu.permutation_vec()[i], j)).margin(1e-10) );
+        }
+    }
+
+    // numerically singular matrix is reported as singular only with explicit tolerance
+    const vector_matrix<double> singular = {{1., 2., 3.}, {4., 5., 6.}, {7., 8., 9.}};
+    vector_matrix<double> s = singular;
+    REQUIRE( !lu_decomposition(execution::seq, s, lu_pivot_tolerance(s)) );
+    s = singular;
+    REQUIRE( !invert_inplace(s, lu_pivot_tolerance(s)) );
+
+}
+
+TEST_CASE("LU-factorization of badly scaled nonsingular matricies succeeds", "[matrix]") {
+
+    const vector_matrix<double> diagonal = {{1., 0.}, {0., 1e-20}};
+    REQUIRE( determinant(diagonal) == 1e-20 );
+    vector_matrix<double> inv;
+    REQUIRE( invert_matrix(diagonal, inv) );
+    REQUIRE( inv(1, 1) == Approx(1e20) );
+
+    // first row is scaled by 1e-20, determinant is -2e-20
+    const vector_matrix<double> scaled = {{1e-20, 2e-20}, {3., 4.}};
+    REQUIRE( determinant(scaled) == Approx(-2e-20) );
+    REQUIRE( invert_matrix(scaled, inv) );
+    REQUIRE( inv(0, 0) == Approx(-2e20) );
+    REQUIRE( inv(1, 1) == Approx(-0.5) );
+
+    vector_matrix<double> m = scaled;
+    REQUIRE( invert_inplace(m) );
+    REQUIRE( m(0, 0) == Approx(-2e20) );
+    REQUIRE( m(1, 0) == Approx(1.5e20) );
+
+    pivoted_matrix<vector_matrix<double>> lu(scaled);
+    REQUIRE( lu_decomposition(lu) );
+    REQUIRE( std::abs(lu(1, 1)) > 0. );
+
+    // relative tolerance rejects them, so it is opt-in
+    m = scaled;
+    REQUIRE( !lu_decomposition(execution::seq, m, lu_pivot_tolerance(m)) );
+
+}
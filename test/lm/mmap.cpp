@@ -0,0 +1,89 @@
+#include <catch.hpp>
+
+#include <cstdio>
+#include <string>
+#include <type_traits>
+
+#include <lm/matrix/mmap.h>
+
+using namespace lm;
+
+namespace {
+
+struct temp_file {
+    std::string path;
+    explicit temp_file(const char* name) : path(name) {}
+    ~temp_file() { std::remove(path.c_str()); }
+};
+
+}
+
+// path is not implicitly converted to matrix which maps file
+static_assert(!std::is_convertible<std::string, mmap_matrix<float>>::value, "mmap_matrix is implicitly constructed from path");
+
+TEST_CASE("mmap_matrix create and reopen", "[mmap]") {
+
+    temp_file f("lm_mmap_test.bin");
+    {
+        mmap_matrix<float> m(f.path, 2, 3);
+        REQUIRE( m.rows() == 2 );
+        REQUIRE( m.cols() == 3 );
+        m.assign(array_matrix<float, 2, 3>({1,2,3,4,5,6}));
+        m.sync();
+    }
+
+    mmap_matrix<float> m(f.path);
+    m.advise(access_pattern::sequential);
+    REQUIRE( m == (array_matrix<float, 2, 3>({1,2,3,4,5,6})) );
+
+}
+
+TEST_CASE("mmap_matrix read_only changes are private", "[mmap]") {
+
+    temp_file f("lm_mmap_private.bin");
+    {
+        mmap_matrix<double, col_major_layout> m(f.path, 2, 2);
+        m.assign(array_matrix<double, 2, 2>({1,2,3,4}));
+    }
+    {
+        mmap_matrix<double, col_major_layout> m(f.path, access_mode::read_only);
+        REQUIRE( m(0, 1) == 2 );
+        m(0, 1) = 10;
+        REQUIRE( m(0, 1) == 10 );
+    }
+
+    mmap_matrix<double, col_major_layout> m(f.path, access_mode::read_write);
+    REQUIRE( m(0, 1) == 2 );
+    REQUIRE( m.data()[2] == 2 );
+
+}
+
+TEST_CASE("mmap_matrix header validation", "[mmap]") {
+
+    temp_file f("lm_mmap_mismatch.bin");
+    {
+        mmap_matrix<float> m(f.path, 2, 2);
+    }
+    REQUIRE_THROWS_AS( mmap_matrix<double>(f.path), std::runtime_error );
+    REQUIRE_THROWS_AS( (mmap_matrix<float, col_major_layout>(f.path)), std::runtime_error );
+    REQUIRE_THROWS_AS( mmap_matrix<float>("lm_mmap_missing.bin"), std::system_error );
+
+}
+
+TEST_CASE("mmap_matrix algorithms", "[mmap]") {
+
+    temp_file f("lm_mmap_algorithm.bin");
+    mmap_matrix<float> m(f.path, 3, 3);
+    m.assign(array_matrix<float, 3, 3>({9,1,2,3,4,5,6,7,8}));
+
+    vector_matrix<float> v = {{1,0,0},{0,1,0},{0,0,1}};
+    vector_matrix<float> p = product(m, v);
+    REQUIRE( p == m );
+
+    REQUIRE( determinant(m) == Approx(-27.f) );
+    REQUIRE( m(0, 0) == 9 );
+
+    vector_matrix<float> t = transpose(m);
+    REQUIRE( t(0, 1) == 3 );
+
+}
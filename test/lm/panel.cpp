@@ -0,0 +1,112 @@
+#include <catch.hpp>
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+#include <lm/matrix/io.h>
+#include <lm/matrix/panel.h>
+
+using namespace lm;
+
+namespace {
+
+vector_matrix<double> make_matrix(size_t rows, size_t cols) {
+    vector_matrix<double> m(rows, cols);
+    for (size_t i = 0; i < rows; i++) {
+        for (size_t j = 0; j < cols; j++) {
+            m(i, j) = static_cast<double>((i * 7 + j * 3) % 11) - 5;
+        }
+    }
+    return m;
+}
+
+}
+
+TEST_CASE("stream_product from in-memory matrix", "[panel]") {
+
+    vector_matrix<double> a = make_matrix(103, 8);
+    vector_matrix<double> b = make_matrix(8, 5);
+
+    vector_matrix<double> c(a.rows(), b.cols());
+    matrix_panel_source<vector_matrix<double>> source(a);
+
+    size_t panels = 0;
+    auto sink = make_panel_sink(c);
+    stream_product(source, b, [&](size_t first, const vector_matrix<double>& p) {
+        REQUIRE( p.rows() <= 10 );
+        sink(first, p);
+        ++panels;
+    }, 10 * (2 * 8 + 5) * sizeof(double));
+
+    REQUIRE( panels == 11 );
+    REQUIRE( c == product(a, b) );
+
+}
+
+TEST_CASE("stream_product from binary stream and mapped file", "[panel]") {
+
+    vector_matrix<double> a = make_matrix(50, 6);
+    vector_matrix<double> b = make_matrix(6, 4);
+    vector_matrix<double> expected = product(a, b);
+
+    std::stringstream ss;
+    save(ss, a);
+
+    vector_matrix<double> c(a.rows(), b.cols());
+    stream_panel_source<double> stream_source(ss);
+    stream_product(stream_source, b, make_panel_sink(c), 4096);
+    REQUIRE( c == expected );
+
+    const std::string path = "lm_panel_test.bin";
+    save(path, a);
+    {
+        mmap_matrix<double> m(path);
+        matrix_panel_source<mmap_matrix<double>> mmap_source(m);
+
+        vector_matrix<double> d(a.rows(), b.cols());
+        stream_product(mmap_source, b, make_panel_sink(d), 1000);
+        REQUIRE( d == expected );
+    }
+    std::remove(path.c_str());
+
+}
+
+TEST_CASE("mapped panel source releases only pages of shared mapping", "[panel]") {
+
+    // several pages of rows, so released ranges end inside of panels
+    vector_matrix<double> a = make_matrix(3000, 7);
+    vector_matrix<double> b = make_matrix(7, 3);
+    vector_matrix<double> expected = product(a, b);
+
+    const std::string path = "lm_panel_release_test.bin";
+    save(path, a);
+    {
+        mmap_matrix<double> shared(path, access_mode::read_write);
+        matrix_panel_source<mmap_matrix<double>> source(shared, true);
+        vector_matrix<double> d(a.rows(), b.cols());
+        stream_product(source, b, make_panel_sink(d), 100 * (2 * 7 + 3) * sizeof(double));
+        REQUIRE( d == expected );
+        // released pages are read back from file
+        REQUIRE( vector_matrix<double>(shared) == a );
+    }
+    {
+        // changes of private mapping are kept
+        mmap_matrix<double> priv(path);
+        priv(0, 0) = 100.;
+        priv(2999, 6) = -100.;
+        matrix_panel_source<mmap_matrix<double>> source(priv, true);
+        vector_matrix<double> d(a.rows(), b.cols());
+        stream_product(source, b, make_panel_sink(d), 100 * (2 * 7 + 3) * sizeof(double));
+        REQUIRE( priv(0, 0) == 100. );
+        REQUIRE( priv(2999, 6) == -100. );
+    }
+    std::remove(path.c_str());
+
+}
+
+TEST_CASE("stream_product budget too small", "[panel]") {
+    vector_matrix<double> a = make_matrix(4, 4);
+    matrix_panel_source<vector_matrix<double>> source(a);
+    REQUIRE_THROWS_AS( stream_product(source, a, [](size_t, const vector_matrix<double>&) {}, 10), std::invalid_argument );
+}
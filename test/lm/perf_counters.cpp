@@ -0,0 +1,70 @@
+#include <catch.hpp>
+
+#include <cstring>
+
+#include <lm/util/perf_counters.h>
+
+using namespace lm;
+
+namespace {
+
+const perf_record* find(const std::vector<perf_record>& records, const char* operation, size_t rows, size_t cols) {
+    for (const perf_record& r : records) {
+        if (std::strcmp(r.operation, operation) == 0 && r.rows == rows && r.cols == cols) {
+            return &r;
+        }
+    }
+    return nullptr;
+}
+
+}
+
+TEST_CASE("shape_bucket rounds up to power of two", "[perf_counters]") {
+    REQUIRE( shape_bucket(0) == 1 );
+    REQUIRE( shape_bucket(1) == 1 );
+    REQUIRE( shape_bucket(3) == 4 );
+    REQUIRE( shape_bucket(64) == 64 );
+    REQUIRE( shape_bucket(65) == 128 );
+}
+
+TEST_CASE("scale_multiplexed extrapolates counts to enabled time", "[perf_counters]") {
+    REQUIRE( scale_multiplexed(100, 10, 10) == 100 );
+    REQUIRE( scale_multiplexed(100, 10, 5) == 200 );
+    REQUIRE( scale_multiplexed(100, 10, 0) == 0 );
+    REQUIRE( scale_multiplexed(0, 0, 0) == 0 );
+}
+
+TEST_CASE("perf_scope aggregates calls per operation and shape", "[perf_counters]") {
+    perf_registry::instance().reset();
+
+    volatile double sum = 0;
+    for (int i = 0; i < 3; i++) {
+        perf_scope scope("test_op", 3, 5);
+        for (int j = 0; j < 1000; j++) {
+            sum = sum + j;
+        }
+    }
+    {
+        perf_scope scope("test_op", 100, 100);
+    }
+
+    const std::vector<perf_record> records = perf_registry::instance().snapshot();
+    REQUIRE( records.size() == 2 );
+
+    const perf_record* small = find(records, "test_op", 4, 8);
+    REQUIRE( small != nullptr );
+    REQUIRE( small->counts.calls == 3 );
+    if (perf_counter_group::current().available()) {
+        REQUIRE( small->counts[perf_event::instructions] > 0 );
+        REQUIRE( small->counts[perf_event::cycles] > 0 );
+    } else {
+        REQUIRE( small->counts[perf_event::instructions] == 0 );
+    }
+
+    const perf_record* big = find(records, "test_op", 128, 128);
+    REQUIRE( big != nullptr );
+    REQUIRE( big->counts.calls == 1 );
+
+    perf_registry::instance().reset();
+    REQUIRE( perf_registry::instance().snapshot().empty() );
+}
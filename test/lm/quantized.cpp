@@ -0,0 +1,148 @@
+#include <catch.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <lm/matrix/quantized.h>
+
+using namespace lm;
+
+namespace {
+
+vector_matrix<float> make_matrix(size_t rows, size_t cols, size_t seed) {
+    vector_matrix<float> m(rows, cols);
+    for (size_t i = 0; i < rows; i++) {
+        for (size_t j = 0; j < cols; j++) {
+            m(i, j) = static_cast<float>((i * 7 + j * 3 + seed) % 23) * 0.1f - 0.7f;
+        }
+    }
+    return m;
+}
+
+}
+
+TEST_CASE("quantize and dequantize", "[quantized]") {
+    const vector_matrix<float> m = make_matrix(5, 9, 1);
+
+    quantized_matrix<int8_t> q;
+    quantize(m, q);
+    REQUIRE( q.rows() == 5 );
+    REQUIRE( q.cols() == 9 );
+
+    vector_matrix<float> d;
+    dequantize(q, d);
+    for (size_t i = 0; i < m.rows(); i++) {
+        for (size_t j = 0; j < m.cols(); j++) {
+            REQUIRE( std::abs(d(i, j) - m(i, j)) <= q.scale(i) * 0.51f );
+        }
+    }
+
+    quantized_matrix<int16_t, quantization_axis::col> q16;
+    quantize(m, q16);
+    REQUIRE( std::abs(q16.dequantized(4, 8) - m(4, 8)) <= q16.scale(8) * 0.51f );
+
+    q16.swap_col(0, 8);
+    REQUIRE( std::abs(q16.dequantized(4, 0) - m(4, 8)) <= q16.scale(0) * 0.51f );
+}
+
+TEST_CASE("dot_i32", "[quantized]") {
+    std::vector<int8_t> a(45), b(45);
+    std::vector<int16_t> a16(45), b16(45);
+    int32_t expected = 0, expected16 = 0;
+    for (size_t i = 0; i < a.size(); i++) {
+        a[i] = static_cast<int8_t>(i % 2 == 0 ? -128 : 127 - i);
+        b[i] = static_cast<int8_t>(i % 3 == 0 ? -128 : i);
+        a16[i] = static_cast<int16_t>(a[i] * 200);
+        b16[i] = static_cast<int16_t>(b[i] * 100);
+        expected += a[i] * b[i];
+        expected16 += a16[i] * b16[i];
+    }
+    for (size_t n = 0; n <= a.size(); n += 11) {
+        int32_t e = 0;
+        for (size_t i = 0; i < n; i++) {
+            e += a[i] * b[i];
+        }
+        REQUIRE( dot_i32(a.data(), b.data(), n) == e );
+    }
+    REQUIRE( dot_i32(a.data(), b.data(), a.size()) == expected );
+    REQUIRE( dot_i32(a16.data(), b16.data(), a16.size()) == expected16 );
+}
+
+TEST_CASE("quantized_product", "[quantized]") {
+    const vector_matrix<float> a = make_matrix(6, 40, 2);
+    const vector_matrix<float> b = make_matrix(40, 7, 5);
+
+    quantized_matrix<int8_t> qa;
+    quantized_matrix<int8_t, quantization_axis::col> qb;
+    quantize(a, qa);
+    quantize(b, qb);
+
+    vector_matrix<float> expected, da, db;
+    dequantize(qa, da);
+    dequantize(qb, db);
+    product_accumulate<double>(da, db, expected);
+
+    vector_matrix<float> r;
+    quantized_product(qa, qb, r);
+    for (size_t i = 0; i < r.rows(); i++) {
+        for (size_t j = 0; j < r.cols(); j++) {
+            REQUIRE( r(i, j) == Approx(expected(i, j)).margin(1e-4) );
+        }
+    }
+}
+
+TEST_CASE("dot_i64 of full range values", "[quantized]") {
+    std::vector<int16_t> a16(1000), b16(1000);
+    std::vector<int8_t> a8(1000), b8(1000);
+    int64_t expected16 = 0, expected8 = 0;
+    for (size_t i = 0; i < a16.size(); i++) {
+        a16[i] = static_cast<int16_t>(i % 5 == 0 ? -32768 : 32767 - i);
+        b16[i] = static_cast<int16_t>(i % 3 == 0 ? -32768 : 32000 + i % 7);
+        a8[i] = static_cast<int8_t>(i % 2 == 0 ? -128 : 127);
+        b8[i] = -128;
+        expected16 += static_cast<int64_t>(a16[i]) * b16[i];
+        expected8 += static_cast<int64_t>(a8[i]) * b8[i];
+    }
+    for (size_t n : { 0, 1, 7, 8, 9, 100, 1000 }) {
+        int64_t e = 0;
+        for (size_t i = 0; i < n; i++) {
+            e += static_cast<int64_t>(a16[i]) * b16[i];
+        }
+        REQUIRE( dot_i64(a16.data(), b16.data(), n) == e );
+    }
+    REQUIRE( dot_i64(a16.data(), b16.data(), a16.size()) == expected16 );
+    REQUIRE( dot_i64(a8.data(), b8.data(), a8.size()) == expected8 );
+}
+
+TEST_CASE("int16 quantized_product of full range values", "[quantized]") {
+    // values are quantized to whole range of int16_t, products of raw values overflow int32_t sums
+    const vector_matrix<float> a = make_matrix(5, 512, 1);
+    const vector_matrix<float> b = make_matrix(512, 6, 4);
+
+    quantized_matrix<int16_t> qa;
+    quantized_matrix<int16_t, quantization_axis::col> qb;
+    quantize(a, qa);
+    quantize(b, qb);
+
+    vector_matrix<double> expected, da, db;
+    dequantize(qa, da);
+    dequantize(qb, db);
+    product(da, db, expected);
+
+    vector_matrix<double> r;
+    quantized_product(qa, qb, r);
+    for (size_t i = 0; i < r.rows(); i++) {
+        for (size_t j = 0; j < r.cols(); j++) {
+            REQUIRE( r(i, j) == Approx(expected(i, j)).margin(1e-6) );
+        }
+    }
+}
+
+TEST_CASE("int8 product with int32 accumulator", "[quantized]") {
+    vector_matrix<int8_t> a = {{100, 100, 100}};
+    vector_matrix<int8_t> b = {{100}, {100}, {100}};
+    vector_matrix<int32_t> r;
+    product_accumulate<int32_t>(a, b, r);
+    REQUIRE( r(0, 0) == 30000 );
+}
@@ -0,0 +1,106 @@
+#include <catch.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+
+#include <lm/matrix/matrix.h>
+#include <lm/matrix/recursive.h>
+#include <lm/util/task_pool.h>
+
+using namespace lm;
+
+namespace {
+
+vector_matrix<double> make_matrix(size_t rows, size_t cols, size_t seed) {
+    vector_matrix<double> m(rows, cols);
+    for (size_t i = 0; i < rows; i++) {
+        for (size_t j = 0; j < cols; j++) {
+            m(i, j) = static_cast<double>((i * 7 + j * 3 + seed) % 11) - 5. + (i == j ? 20. : 0.);
+        }
+    }
+    return m;
+}
+
+}
+
+TEST_CASE("recursive product and transpose match loop ones", "[recursive]") {
+
+    typedef vector_matrix<double, col_major_layout> col;
+
+    task_pool pool(3);
+    const execution_policy par = execution::par.with_pool(pool);
+
+    const vector_matrix<double> a = make_matrix(97, 70, 1), b = make_matrix(70, 45, 2);
+
+    vector_matrix<double> p1, p2, p3;
+    product(a, b, p1);
+    product_recursive(execution::seq, a, b, p2);
+    product_recursive(par, a, b, p3);
+    REQUIRE( p1 == p2 );
+    REQUIRE( p1 == p3 );
+
+    col c1, c2;
+    product(col(a), col(b), c1);
+    product_recursive(par, col(a), col(b), c2);
+    REQUIRE( c1 == c2 );
+
+    vector_matrix<double> t1, t2;
+    transpose(a, t1);
+    transpose_recursive(par, a, t2);
+    REQUIRE( t1 == t2 );
+
+    col t3;
+    transpose_recursive(par, b, t3);
+    REQUIRE( t3 == col(transposed(b)) );
+
+    vector_matrix<double> e;
+    product_recursive(par, vector_matrix<double>(0, 3), vector_matrix<double>(3, 4), e);
+    REQUIRE( e.rows() == 0 );
+    REQUIRE( e.cols() == 4 );
+
+}
+
+TEST_CASE("recursive LU-factorization", "[recursive]") {
+
+    task_pool pool(3);
+    const execution_policy par = execution::par.with_pool(pool);
+
+    for (size_t n : { 1, 7, 33, 100 }) {
+        // pivots may differ from `lu_decomposition` by rounding, so factorization is checked by product
+        const vector_matrix<double> a = make_matrix(n, n, n);
+
+        pivoted_matrix<vector_matrix<double>> lu2(a);
+        REQUIRE( lu_decomposition_recursive(par, lu2) );
+
+        // P A = L U up to rounding error, which is bounded relative to |L| |U|
+        for (size_t i = 0; i < n; i++) {
+            for (size_t j = 0; j < n; j++) {
+                double s = 0, bound = 0;
+                for (size_t k = 0; k <= std::min(i, j); k++) {
+                    const double l = k == i ? 1. : lu2(i, k);
+                    s += l * lu2(k, j);
+                    bound += std::abs(l * lu2(k, j));
+                }
+                REQUIRE( std::abs(s - a(lu2.permutation_vec()[i], j)) <= 1e-13 * n * bound );
+            }
+        }
+    }
+
+    vector_matrix<double> singular = make_matrix(40, 40, 3);
+    for (size_t j = 0; j < 40; j++) {
+        singular(39, j) = singular(0, j);
+    }
+    pivoted_matrix<vector_matrix<double>> s(singular);
+    REQUIRE( !lu_decomposition_recursive(par, s) );
+
+    // only exact zero pivots are rejected by default, so badly scaled nonsingular matrix is factorized
+    vector_matrix<double> scaled = {{1e-20, 2e-20}, {3., 4.}};
+    pivoted_matrix<vector_matrix<double>> ls(scaled);
+    REQUIRE( lu_decomposition_recursive(par, ls) );
+
+    vector_matrix<double> r(3, 4);
+    REQUIRE_THROWS_AS( lu_decomposition_recursive(par, r), std::invalid_argument );
+
+}
@@ -0,0 +1,97 @@
+#include <catch.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include <lm/matrix/matrix.h>
+#include <lm/util/reduce.h>
+#include <lm/util/task_pool.h>
+#include <lm/vec/vec.h>
+
+using namespace lm;
+
+namespace {
+
+// terms of very different magnitudes, so any change of summation order changes result
+double term(size_t i) {
+    return std::sin(static_cast<double>(i)) * std::pow(10., static_cast<double>(i % 17) - 8.);
+}
+
+}
+
+TEST_CASE("reproducible_sum doesn't depend on threads", "[reduce]") {
+
+    REQUIRE( reproducible_sum<double>(execution::seq, 0, term) == 0 );
+    REQUIRE( reproducible_sum<double>(execution::seq, 3, term) == (term(0) + term(1)) + term(2) );
+    REQUIRE( reproducible_sum<int>(execution::par, 1000, [](size_t i) { return static_cast<int>(i); }) == 499500 );
+
+    task_pool pool(3);
+    for (size_t n : { 1, 255, 256, 257, 1000, 4096, 100000 }) {
+        const double expected = reproducible_sum<double>(execution::seq, n, term);
+        for (size_t threads = 1; threads <= 8; threads++) {
+            const execution_policy policy = execution::par.with_pool(pool).with_threads(threads).with_grain(1);
+            REQUIRE( reproducible_sum<double>(policy, n, term) == expected );
+        }
+        REQUIRE( reproducible_sum<double>(execution::par_simd, n, term) == expected );
+    }
+
+    // pairwise summation is more accurate than running sum
+    const size_t n = 1 << 20;
+    float running = 0;
+    for (size_t i = 0; i < n; i++) {
+        running += 0.1f;
+    }
+    const float pairwise = reproducible_sum<float>(execution::seq, n, [](size_t) { return 0.1f; });
+    REQUIRE( std::abs(pairwise - n * 0.1) < std::abs(running - n * 0.1) );
+    REQUIRE( std::abs(pairwise - n * 0.1) < 1 );
+
+}
+
+TEST_CASE("reductions and products are bit-identical for any policy", "[reduce]") {
+
+    task_pool pool(3);
+
+    vector_matrix<double> a(300, 70), b(70, 50);
+    for (size_t i = 0; i < a.rows(); i++) {
+        for (size_t j = 0; j < a.cols(); j++) {
+            a(i, j) = term(i * a.cols() + j);
+        }
+    }
+    for (size_t i = 0; i < b.rows(); i++) {
+        for (size_t j = 0; j < b.cols(); j++) {
+            b(i, j) = term(i + j * 31);
+        }
+    }
+
+    const double s = sum(execution::seq, a);
+    const double f = scalar_product(execution::seq, a, a);
+    vector_matrix<double> p;
+    product(a, b, p);
+
+    for (size_t threads = 1; threads <= 8; threads++) {
+        const execution_policy policy = execution::par.with_pool(pool).with_threads(threads).with_grain(1);
+        REQUIRE( sum(policy, a) == s );
+        REQUIRE( scalar_product(policy, a, a) == f );
+        vector_matrix<double> q;
+        product(policy, a, b, q);
+        REQUIRE( q == p );
+    }
+    REQUIRE( sum<long double>(execution::par, a) == Approx(s) );
+
+    vec<double, 1000> v1, v2;
+    for (size_t i = 0; i < v1.size(); i++) {
+        v1[i] = term(i);
+        v2[i] = term(i + 7);
+    }
+    const double d = v1.scalar_product(execution::seq, v2);
+    const double l = v1.length_square(execution::seq);
+    REQUIRE( d == Approx(v1.scalar_product(v2)) );
+    REQUIRE( l == Approx(v1.length_square()) );
+    for (size_t threads = 2; threads <= 8; threads++) {
+        const execution_policy policy = execution::par.with_pool(pool).with_threads(threads).with_grain(1);
+        REQUIRE( v1.scalar_product(policy, v2) == d );
+        REQUIRE( v1.length_square(policy) == l );
+    }
+
+}
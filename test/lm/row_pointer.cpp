@@ -0,0 +1,62 @@
+#include <catch.hpp>
+
+#include <cstddef>
+#include <vector>
+
+#include <lm/matrix/row_pointer.h>
+
+using namespace lm;
+
+TEST_CASE("row_pointer_matrix swaps rows without moving elements", "[row_pointer]") {
+
+    vector_row_pointer_matrix<int> m = {{1, 2, 3}, {4, 5, 6}, {7, 8, 9}};
+    const int* first = m.row_data(0);
+
+    m.swap_row(0, 2);
+    REQUIRE( m == (vector_matrix<int>{{7, 8, 9}, {4, 5, 6}, {1, 2, 3}}) );
+    REQUIRE( m.row_data(2) == first );
+    REQUIRE( m.value() == (std::vector<int>{1, 2, 3, 4, 5, 6, 7, 8, 9}) );
+    REQUIRE( !m.is_compact() );
+
+    m.swap_col(0, 2);
+    REQUIRE( m == (vector_matrix<int>{{9, 8, 7}, {6, 5, 4}, {3, 2, 1}}) );
+
+}
+
+TEST_CASE("row_pointer_matrix permute_rows and compact", "[row_pointer]") {
+
+    vector_row_pointer_matrix<int> m = {{1, 2}, {3, 4}, {5, 6}, {7, 8}};
+    const size_t p[] = {2, 0, 3, 1};
+    m.permute_rows(p);
+    REQUIRE( m == (vector_matrix<int>{{5, 6}, {1, 2}, {7, 8}, {3, 4}}) );
+
+    m.compact();
+    REQUIRE( m.is_compact() );
+    REQUIRE( m == (vector_matrix<int>{{5, 6}, {1, 2}, {7, 8}, {3, 4}}) );
+    REQUIRE( m.value() == (std::vector<int>{5, 6, 1, 2, 7, 8, 3, 4}) );
+
+}
+
+TEST_CASE("row_pointer_matrix in algorithms", "[row_pointer]") {
+
+    const vector_matrix<double> a = {{0., 2., 1.}, {1., 1., 0.}, {3., 0., 1.}};
+    vector_row_pointer_matrix<double> r(a);
+
+    REQUIRE( determinant(r) == Approx(determinant(a)) );
+
+    // pivoting of row pointer matrix only exchanges row offsets
+    pivoted_matrix<vector_row_pointer_matrix<double>> lu(a);
+    permutation_matrix<vector_matrix<double>> expected(a);
+    REQUIRE( lu_decomposition(lu) );
+    REQUIRE( lu_decomposition(expected) );
+    REQUIRE( lu == expected );
+    REQUIRE( lu.permutation_count() > 0 );
+    for (size_t i = 0; i < a.rows(); i++) {
+        REQUIRE( lu.value().row_data(i) == lu.value().value().data() + lu.permutation_vec()[i] * a.cols() );
+    }
+
+    vector_matrix<double> p;
+    product(r, a, p);
+    REQUIRE( p == product(a, a) );
+
+}
@@ -0,0 +1,61 @@
+#include <catch.hpp>
+
+#include <utility>
+
+#include <lm/util/small_vector.h>
+#include <lm/matrix/matrix.h>
+
+using namespace lm;
+
+TEST_CASE("small_vector keeps small sizes inline", "[small_vector]") {
+    small_vector<int, 4> v = {1, 2, 3};
+    REQUIRE( v.is_inline() );
+    REQUIRE( v.size() == 3 );
+
+    v.resize(4);
+    REQUIRE( v.is_inline() );
+    REQUIRE( v[2] == 3 );
+    REQUIRE( v[3] == 0 );
+
+    v.resize(10);
+    REQUIRE( !v.is_inline() );
+    REQUIRE( v.size() == 10 );
+    REQUIRE( v[0] == 1 );
+    REQUIRE( v[9] == 0 );
+}
+
+TEST_CASE("small_vector copy and move", "[small_vector]") {
+    small_vector<int, 2> heap = {1, 2, 3};
+    const int* data = heap.data();
+
+    small_vector<int, 2> copy = heap;
+    REQUIRE( copy.data() != data );
+    REQUIRE( copy[2] == 3 );
+
+    small_vector<int, 2> moved = std::move(heap);
+    REQUIRE( moved.data() == data );
+    REQUIRE( heap.empty() );
+    REQUIRE( heap.is_inline() );
+
+    small_vector<int, 2> small = {7};
+    moved = std::move(small);
+    REQUIRE( moved.is_inline() );
+    REQUIRE( moved.size() == 1 );
+    REQUIRE( moved[0] == 7 );
+}
+
+TEST_CASE("small_matrix", "[small_vector]") {
+    small_matrix<double> m = {
+        {  9.,  1.,  2. },
+        {  3.,  4.,  5. },
+        {  6.,  7.,  8. }
+    };
+    REQUIRE( m.value().is_inline() );
+    REQUIRE( m.determinant() == Approx(-27.) );
+
+    small_matrix<double> inv = ~m;
+    REQUIRE( (m * inv)(1, 1) == Approx(1.) );
+
+    m.resize(9, 9);
+    REQUIRE( !m.value().is_inline() );
+}
@@ -0,0 +1,96 @@
+#include <catch.hpp>
+
+#include <thread>
+
+#include <lm/util/stats.h>
+#include <lm/matrix/matrix.h>
+
+using namespace lm;
+
+TEST_CASE("stats_size_class groups by largest dimension", "[stats]") {
+    REQUIRE( stats_size_class(0, 0) == 0 );
+    REQUIRE( stats_size_class(1, 1) == 1 );
+    REQUIRE( stats_size_class(3, 2) == 2 );
+    REQUIRE( stats_size_class(4, 1) == 3 );
+    REQUIRE( stats_size_class(1, 100) == 7 );
+}
+
+TEST_CASE("stats_scope counts calls, flops and allocations", "[stats]") {
+    stats_registry::instance().reset();
+
+    stats_scope::allocated(1000);
+    {
+        stats_scope outer(stats_operation::invert_matrix, 10, 10, 2000);
+        stats_scope::allocated(800);
+        {
+            stats_scope inner(stats_operation::lu_decomposition, 10, 10, 600);
+            stats_scope::allocated(80);
+        }
+        stats_scope::allocated(8);
+    }
+
+    const stats_counts invert = stats_registry::instance().total(stats_operation::invert_matrix);
+    REQUIRE( invert.calls == 1 );
+    REQUIRE( invert.flops == 2000 );
+    REQUIRE( invert.allocated_bytes == 808 );
+
+    const stats_counts lu = stats_registry::instance().total(stats_operation::lu_decomposition);
+    REQUIRE( lu.calls == 1 );
+    REQUIRE( lu.flops == 600 );
+    REQUIRE( lu.allocated_bytes == 80 );
+    REQUIRE( invert.nanoseconds >= lu.nanoseconds );
+
+    const std::vector<stats_record> records = stats_registry::instance().snapshot();
+    REQUIRE( records.size() == 2 );
+    REQUIRE( records[0].operation == stats_operation::lu_decomposition );
+    REQUIRE( records[0].size_class == stats_size_class(10, 10) );
+
+    stats_registry::instance().reset();
+    REQUIRE( stats_registry::instance().snapshot().empty() );
+}
+
+TEST_CASE("stats of finished threads are kept", "[stats]") {
+    stats_registry::instance().reset();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([]() {
+            for (int i = 0; i < 100; i++) {
+                stats_scope s(stats_operation::product, 4, 4, 128);
+            }
+        });
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+
+    const stats_counts product = stats_registry::instance().total(stats_operation::product);
+    REQUIRE( product.calls == 400 );
+    REQUIRE( product.flops == 400 * 128 );
+}
+
+#if defined(LM_STATS)
+TEST_CASE("element-wise operators are counted", "[stats]") {
+    stats_registry::instance().reset();
+
+    vector_matrix<double> a = {{1, 2, 3}, {4, 5, 6}}, b = {{6, 5, 4}, {3, 2, 1}};
+    vector_matrix<double> c = a + b;
+    c -= a;
+    REQUIRE( c == b );
+
+    const stats_counts dynamic = stats_registry::instance().total(stats_operation::elementwise);
+    REQUIRE( dynamic.calls == 2 );
+    REQUIRE( dynamic.flops == 12 );
+    REQUIRE( dynamic.allocated_bytes == 6 * sizeof(double) );
+
+    stats_registry::instance().reset();
+    array_matrix<int, 2, 2> s = {{1, 2}, {3, 4}};
+    array_matrix<int, 2, 2> d = s - s;
+    REQUIRE( d(1, 1) == 0 );
+
+    const stats_counts fixed = stats_registry::instance().total(stats_operation::elementwise);
+    REQUIRE( fixed.calls == 1 );
+    REQUIRE( fixed.flops == 4 );
+    REQUIRE( fixed.allocated_bytes == 0 );
+}
+#endif
@@ -0,0 +1,99 @@
+#include <catch.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+#include <lm/util/execution.h>
+#include <lm/util/task_pool.h>
+
+using namespace lm;
+
+namespace {
+
+size_t fibonacci(task_pool& pool, size_t n) {
+    if (n < 2) {
+        return n;
+    }
+    size_t a = 0, b = 0;
+    pool.fork_join([&]() { a = fibonacci(pool, n - 1); }, [&]() { b = fibonacci(pool, n - 2); });
+    return a + b;
+}
+
+}
+
+TEST_CASE("task_pool runs nested fork_join", "[task_pool]") {
+
+    task_pool pool(3);
+    REQUIRE( pool.workers() == 3 );
+    REQUIRE( pool.concurrency() == 4 );
+    REQUIRE( fibonacci(pool, 20) == 6765 );
+
+    // pool without workers runs tasks on calling thread
+    task_pool inline_pool(0);
+    REQUIRE( fibonacci(inline_pool, 15) == 610 );
+
+    // recursion deeper than capacity of deque runs remaining tasks inline
+    std::atomic<size_t> leaves(0);
+    std::function<void(size_t)> chain = [&](size_t depth) {
+        if (depth == 0) {
+            leaves++;
+            return;
+        }
+        pool.fork_join([&]() { chain(depth - 1); }, [&]() { leaves++; });
+    };
+    chain(task_deque::capacity * 2);
+    REQUIRE( leaves == task_deque::capacity * 2 + 1 );
+
+}
+
+TEST_CASE("task_pool rethrows exceptions after join", "[task_pool]") {
+
+    task_pool pool(2);
+    std::atomic<int> completed(0);
+    REQUIRE_THROWS_AS( pool.fork_join([&]() { completed++; }, [&]() -> void { throw std::runtime_error("f2"); }),
+                       std::runtime_error );
+    REQUIRE_THROWS_AS( pool.fork_join([&]() -> void { throw std::logic_error("f1"); }, [&]() { completed++; }),
+                       std::logic_error );
+    REQUIRE( completed == 2 );
+
+    // when deque is full tasks run inline and second one runs even if first one throws
+    std::function<void(size_t)> chain = [&](size_t depth) {
+        if (depth == 0) {
+            throw std::runtime_error("leaf");
+        }
+        pool.fork_join([&]() { chain(depth - 1); }, [&]() { completed++; });
+    };
+    completed = 0;
+    REQUIRE_THROWS_AS( chain(task_deque::capacity * 2), std::runtime_error );
+    REQUIRE( completed == static_cast<int>(task_deque::capacity * 2) );
+
+    // pool is usable after exceptions
+    REQUIRE( fibonacci(pool, 10) == 55 );
+
+}
+
+TEST_CASE("parallel_for runs on pool of application", "[task_pool]") {
+
+    task_pool pool(3);
+    const execution_policy policy = execution::par.with_pool(pool).with_grain(1);
+    REQUIRE( &policy.executor() == &pool );
+    REQUIRE( policy.thread_count() == 4 );
+    REQUIRE( &execution::par.executor() == &task_pool::instance() );
+
+    std::vector<std::atomic<int>> visits(1000);
+    for (auto& v : visits) {
+        v = 0;
+    }
+    parallel_for(policy, 0, visits.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            visits[i]++;
+        }
+    });
+    for (auto& v : visits) {
+        REQUIRE( v == 1 );
+    }
+
+}
@@ -0,0 +1,143 @@
+#include <catch.hpp>
+
+#include <sstream>
+#include <string>
+
+#include <lm/matrix/text.h>
+
+using namespace lm;
+
+TEST_CASE("read csv", "[text]") {
+
+    std::istringstream in("a,b,c\n1, 2.5, -3e2\r\n\n4,5,6.25\n");
+    vector_matrix<double> m;
+    read_text(in, m, text_format(',', 1));
+
+    REQUIRE( m.rows() == 2 );
+    REQUIRE( m.cols() == 3 );
+    REQUIRE( m == (array_matrix<double, 2, 3>({1.0, 2.5, -300.0, 4.0, 5.0, 6.25})) );
+
+}
+
+TEST_CASE("read whitespace separated buffer", "[text]") {
+
+    const std::string text = "  1\t2   3\n4 5 6";
+    vector_matrix<int, col_major_layout> m;
+    read_text(text.data(), text.size(), m, text_format::whitespace());
+
+    REQUIRE( m == (array_matrix<int, 2, 3>({1, 2, 3, 4, 5, 6})) );
+
+}
+
+TEST_CASE("read malformed text", "[text]") {
+
+    vector_matrix<float> m;
+
+    std::istringstream mismatch("1,2\n3\n");
+    REQUIRE_THROWS_AS( read_text(mismatch, m), std::runtime_error );
+
+    std::istringstream garbage("1,x\n");
+    REQUIRE_THROWS_AS( read_text(garbage, m), std::runtime_error );
+
+    vector_matrix<int8_t> i;
+    std::istringstream overflow("1,2\n1,300\n");
+    REQUIRE_THROWS_AS( read_text(overflow, i), std::out_of_range );
+    try {
+        std::istringstream again("1,2\n1,300\n");
+        read_text(again, i);
+    } catch (const std::out_of_range& e) {
+        REQUIRE( std::string(e.what()).find("at line 2") != std::string::npos );
+    }
+
+    // matrix keeps its dimensions and elements if text is malformed
+    vector_matrix<float> filled = {{1, 2, 3}, {4, 5, 6}};
+    vector_matrix<double, col_major_layout> col = {{1, 2}, {3, 4}};
+    for (const char* text : { "7,8,9\n10,x\n", "7,8\n9\n" }) {
+        std::istringstream in(text);
+        REQUIRE_THROWS_AS( read_text(in, filled), std::runtime_error );
+        REQUIRE( filled.rows() == 2 );
+        REQUIRE( filled.cols() == 3 );
+        REQUIRE( filled.value().size() == 6 );
+        REQUIRE( filled == (array_matrix<float, 2, 3>({1, 2, 3, 4, 5, 6})) );
+    }
+    std::istringstream bad_col("7,8\n9,x\n");
+    REQUIRE_THROWS_AS( read_text(bad_col, col), std::runtime_error );
+    REQUIRE( col == (array_matrix<double, 2, 2>({1, 2, 3, 4})) );
+
+}
+
+TEST_CASE("parse numbers", "[text]") {
+
+    const char* values[] = { "0.1", "1e-5", "123456789012345678901234", "-0.0", "3.4028235e38", "2.2250738585072014e-308", "inf" };
+    for (const char* v : values) {
+        double d = 0;
+        REQUIRE( text_number<double>::parse(v, v + std::strlen(v), d) == v + std::strlen(v) );
+        REQUIRE( d == std::strtod(v, nullptr) );
+
+        float f = 0;
+        REQUIRE( text_number<float>::parse(v, v + std::strlen(v), f) == v + std::strlen(v) );
+        REQUIRE( f == std::strtof(v, nullptr) );
+    }
+
+}
+
+TEST_CASE("write and read back", "[text]") {
+
+    vector_matrix<double> m = {{0.1, 1.0 / 3, -2.0}, {1e300, 5e-324, 42.0}};
+
+    std::stringstream ss;
+    write_text(ss, m);
+    REQUIRE( ss.str().substr(0, 4) == "0.1," );
+
+    vector_matrix<double> r;
+    read_text(ss, r);
+    REQUIRE( r == m );
+
+    std::ostringstream os;
+    os << array_matrix<int, 2, 2>({1, -2, 3, 40});
+    REQUIRE( os.str() == "1 -2\n3 40\n" );
+
+}
+
+TEST_CASE("write errors are reported", "[text]") {
+
+    vector_matrix<double> m = {{1., 2.}, {3., 4.}};
+    std::ostringstream bad;
+    bad.setstate(std::ios::badbit);
+    REQUIRE_THROWS_AS( write_text(bad, m), std::runtime_error );
+
+    std::ostringstream os;
+    os.setstate(std::ios::failbit);
+    os << m;
+    REQUIRE( !os );
+
+}
+
+TEST_CASE("parse long double", "[text]") {
+
+    const char* values[] = { "0.1", "12345678901234567890", "1e22", "-2.5" };
+    for (const char* v : values) {
+        long double d = 0;
+        REQUIRE( text_number<long double>::parse(v, v + std::strlen(v), d) == v + std::strlen(v) );
+        REQUIRE( d == std::strtold(v, nullptr) );
+    }
+
+}
+
+TEST_CASE("read text larger than parser chunk", "[text]") {
+
+    vector_matrix<float> m(5000, 7);
+    for (size_t i = 0; i < m.rows(); i++) {
+        for (size_t j = 0; j < m.cols(); j++) {
+            m(i, j) = static_cast<float>(i) / 7.f + static_cast<float>(j);
+        }
+    }
+
+    std::stringstream ss;
+    write_text(ss, m, text_format::tsv());
+
+    vector_matrix<float> r;
+    read_text(ss, r, text_format::tsv());
+    REQUIRE( r == m );
+
+}
@@ -81,3 +81,19 @@ TEST_CASE("length()", "[vec]") {
     vec<int, 3> v = { 3, 0, 4 };
     REQUIRE( v.length() == 5 );
 }
+
+TEST_CASE("operations with vectors of other size", "[vec]") {
+    vec<int, 16> v;
+    v = 1;
+    v += std::initializer_list<int>({ 1, 2 });
+    REQUIRE( v[0] == 2 );
+    REQUIRE( v[1] == 3 );
+    REQUIRE( v[2] == 1 );
+    REQUIRE( v[15] == 1 );
+    REQUIRE( v.scalar_product(std::initializer_list<int>({ 1, 2 })) == 8 );
+
+    vec<int, 2> s = { 1, 2 };
+    s += v;
+    REQUIRE( (s == vec<int, 2>({3, 5})) );
+    REQUIRE( s.scalar_product(v) == 21 );
+}